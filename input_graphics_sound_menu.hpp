@@ -2,151 +2,5283 @@
 #define INPUT_GRAPHICS_SOUND_MENU_HPP
 
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <functional>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define INPUT_GRAPHICS_SOUND_MENU_USE_SSE
+#endif
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
-#include "sbpt_generated_includes.hpp"
+#include "sbpt_generated_includes.hpp"
+
+enum class UIState {
+    // TODO remove the dummy state and fill in with all the states you need
+    MAIN_MENU,
+
+    SETTINGS_MENU,
+    PROGRAM_SETTINGS,
+    INPUT_SETTINGS,
+    SOUND_SETTINGS,
+    GRAPHICS_SETTINGS,
+    ADVANCED_SETTINGS,
+    MOUSE_SETTINGS,
+
+    ABOUT,
+};
+
+/**
+ * @brief Specialize this for a state enum to describe a menu to MenuSystem.
+ *
+ * The specialization provides num_states, the states must be the enum values 0 to num_states - 1, and two constexpr
+ * arrays of (state, state) pairs: dependencies, where the second state's ui is drawn behind the first's, and
+ * transitions, the state changes the menu's controls may make. Going back to the previous state is always allowed.
+ */
+template <typename StateEnum> struct MenuStateTable;
+
+template <> struct MenuStateTable<UIState> {
+    static constexpr std::size_t num_states = static_cast<std::size_t>(UIState::ABOUT) + 1;
+
+    static constexpr std::array<std::pair<UIState, UIState>, 6> dependencies = {{
+        {UIState::PROGRAM_SETTINGS, UIState::SETTINGS_MENU},
+        {UIState::INPUT_SETTINGS, UIState::SETTINGS_MENU},
+        {UIState::SOUND_SETTINGS, UIState::SETTINGS_MENU},
+        {UIState::GRAPHICS_SETTINGS, UIState::SETTINGS_MENU},
+        {UIState::ADVANCED_SETTINGS, UIState::SETTINGS_MENU},
+        {UIState::MOUSE_SETTINGS, UIState::SETTINGS_MENU},
+    }};
+
+    static constexpr std::array<std::pair<UIState, UIState>, 8> transitions = {{
+        {UIState::MAIN_MENU, UIState::PROGRAM_SETTINGS},
+        {UIState::MAIN_MENU, UIState::ABOUT},
+        {UIState::SETTINGS_MENU, UIState::PROGRAM_SETTINGS},
+        {UIState::SETTINGS_MENU, UIState::INPUT_SETTINGS},
+        {UIState::SETTINGS_MENU, UIState::SOUND_SETTINGS},
+        {UIState::SETTINGS_MENU, UIState::GRAPHICS_SETTINGS},
+        {UIState::SETTINGS_MENU, UIState::ADVANCED_SETTINGS},
+        {UIState::INPUT_SETTINGS, UIState::MOUSE_SETTINGS},
+    }};
+};
+
+namespace menu_system_tables {
+
+template <typename StateEnum, std::size_t num_states> struct RenderOrder {
+    std::array<StateEnum, num_states> states{};
+    std::size_t size = 0;
+
+    constexpr const StateEnum *begin() const { return states.data(); }
+    constexpr const StateEnum *end() const { return states.data() + size; }
+};
+
+template <typename StateEnum> constexpr std::size_t to_index(StateEnum state) {
+    return static_cast<std::size_t>(state);
+}
+
+template <typename Table> constexpr bool all_states_in_range() {
+    for (const auto &[from, to] : Table::dependencies) {
+        if (to_index(from) >= Table::num_states || to_index(to) >= Table::num_states) {
+            return false;
+        }
+    }
+    for (const auto &[from, to] : Table::transitions) {
+        if (to_index(from) >= Table::num_states || to_index(to) >= Table::num_states) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Table> constexpr auto compute_transition_matrix() {
+    std::array<std::array<bool, Table::num_states>, Table::num_states> allowed{};
+    for (std::size_t i = 0; i < Table::num_states; ++i) {
+        allowed[i][i] = true;
+    }
+    for (const auto &[from, to] : Table::transitions) {
+        allowed[to_index(from)][to_index(to)] = true;
+    }
+    return allowed;
+}
+
+template <typename StateEnum, typename Table> constexpr bool depends_on(StateEnum state, StateEnum dependency) {
+    for (const auto &[dependent, dependency_of_dependent] : Table::dependencies) {
+        if (dependent == state && dependency_of_dependent == dependency) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Everything the state depends on, directly or not, including the state itself.
+ */
+template <typename StateEnum, typename Table>
+constexpr std::array<bool, Table::num_states> compute_reachable_states(StateEnum state) {
+    std::array<bool, Table::num_states> reachable{};
+    reachable[to_index(state)] = true;
+    for (bool found_new_state = true; found_new_state;) {
+        found_new_state = false;
+        for (const auto &[dependent, dependency] : Table::dependencies) {
+            if (reachable[to_index(dependent)] && !reachable[to_index(dependency)]) {
+                reachable[to_index(dependency)] = true;
+                found_new_state = true;
+            }
+        }
+    }
+    return reachable;
+}
+
+template <typename StateEnum, typename Table> constexpr bool has_dependency_cycle() {
+    // a state on a cycle can reach itself through one of its dependencies
+    for (const auto &[dependent, dependency] : Table::dependencies) {
+        if (compute_reachable_states<StateEnum, Table>(dependency)[to_index(dependent)]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief For every state, the state and everything it depends on in painter's order: each ui comes after every ui it
+ * is drawn over, so the state itself comes last.
+ *
+ * This is a topological sort of the dependencies reachable from the state, so it holds for any dependency dag, not
+ * just a single background per state. Ties go to the state declared first in the enum.
+ */
+template <typename StateEnum, typename Table> constexpr auto compute_render_orders() {
+    std::array<RenderOrder<StateEnum, Table::num_states>, Table::num_states> render_orders{};
+    if (has_dependency_cycle<StateEnum, Table>()) {
+        return render_orders; // MenuSystem fails to compile in this case
+    }
+    for (std::size_t i = 0; i < Table::num_states; ++i) {
+        auto &order = render_orders[i];
+        std::array<bool, Table::num_states> reachable =
+            compute_reachable_states<StateEnum, Table>(static_cast<StateEnum>(i));
+        std::array<bool, Table::num_states> ordered{};
+        for (bool ordered_new_state = true; ordered_new_state;) {
+            ordered_new_state = false;
+            for (std::size_t candidate = 0; candidate < Table::num_states; ++candidate) {
+                if (!reachable[candidate] || ordered[candidate]) {
+                    continue;
+                }
+                bool dependencies_ordered = true;
+                for (std::size_t dependency = 0; dependency < Table::num_states; ++dependency) {
+                    if (!ordered[dependency] && depends_on<StateEnum, Table>(static_cast<StateEnum>(candidate),
+                                                                             static_cast<StateEnum>(dependency))) {
+                        dependencies_ordered = false;
+                    }
+                }
+                if (dependencies_ordered) {
+                    order.states[order.size++] = static_cast<StateEnum>(candidate);
+                    ordered[candidate] = true;
+                    ordered_new_state = true;
+                    break;
+                }
+            }
+        }
+    }
+    return render_orders;
+}
+
+} // namespace menu_system_tables
+
+/**
+ * @class MenuSystem
+ * @brief The render orders and allowed transitions of a menu, computed at compile time from its MenuStateTable.
+ *
+ * Nothing here runs per frame other than indexing into the tables, and a transition that isn't in the table fails to
+ * compile when it is made through transition_allowed in a static_assert.
+ */
+template <typename StateEnum> class MenuSystem {
+  public:
+    using Table = MenuStateTable<StateEnum>;
+    static constexpr std::size_t num_states = Table::num_states;
+    using RenderOrder = menu_system_tables::RenderOrder<StateEnum, num_states>;
+
+    static_assert(menu_system_tables::all_states_in_range<Table>(), "the menu state table uses a state out of range");
+    static_assert(!menu_system_tables::has_dependency_cycle<StateEnum, Table>(),
+                  "the ui dependencies of the menu state table form a cycle");
+
+    static constexpr std::size_t index(StateEnum state) { return menu_system_tables::to_index(state); }
+
+    /**
+     * @brief The states to process and render when the menu is in the given state, back to front, so the state
+     * itself comes last.
+     */
+    static constexpr const RenderOrder &get_render_order(StateEnum state) { return render_orders[index(state)]; }
+
+    /**
+     * @param from the state whose ui holds the control making the transition, the transition is also allowed while
+     * that ui is drawn behind another state
+     */
+    static constexpr bool transition_allowed(StateEnum from, StateEnum to) {
+        return transition_matrix[index(from)][index(to)];
+    }
+
+  private:
+    static constexpr auto render_orders = menu_system_tables::compute_render_orders<StateEnum, Table>();
+    static constexpr auto transition_matrix = menu_system_tables::compute_transition_matrix<Table>();
+};
+
+/**
+ * @brief The mixing buses whose gain can be controlled from the sound settings.
+ *
+ * @note MASTER is applied on top of every other bus, the COUNT entry is only used for sizing arrays.
+ */
+enum class SoundBus {
+    MASTER,
+    UI,
+    MUSIC,
+    EFFECTS,
+
+    COUNT,
+};
+
+namespace sound_bus_kernels {
+
+/**
+ * @brief Multiplies every sample in place by a constant gain.
+ */
+inline void apply_gain(float *samples, std::size_t count, float gain) {
+    std::size_t i = 0;
+#ifdef INPUT_GRAPHICS_SOUND_MENU_USE_SSE
+    const __m128 gain_vec = _mm_set1_ps(gain);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(samples + i, _mm_mul_ps(_mm_loadu_ps(samples + i), gain_vec));
+    }
+#endif
+    for (; i < count; ++i) {
+        samples[i] *= gain;
+    }
+}
+
+/**
+ * @brief Multiplies the samples by a gain that moves linearly from start_gain towards end_gain across the block, the
+ * last sample gets exactly end_gain.
+ *
+ * @note ramping a gain change across a whole block instead of jumping to it is what keeps volume changes click-free.
+ */
+inline void apply_gain_ramp(float *samples, std::size_t count, float start_gain, float end_gain) {
+    if (count == 0) {
+        return;
+    }
+    const float step = (end_gain - start_gain) / static_cast<float>(count);
+    std::size_t i = 0;
+#ifdef INPUT_GRAPHICS_SOUND_MENU_USE_SSE
+    __m128 gain_vec =
+        _mm_setr_ps(start_gain + step, start_gain + 2 * step, start_gain + 3 * step, start_gain + 4 * step);
+    const __m128 step_vec = _mm_set1_ps(4 * step);
+    // stops before the last sample so it is always left for the exact end_gain below
+    for (; i + 4 < count; i += 4) {
+        _mm_storeu_ps(samples + i, _mm_mul_ps(_mm_loadu_ps(samples + i), gain_vec));
+        gain_vec = _mm_add_ps(gain_vec, step_vec);
+    }
+#endif
+    for (; i + 1 < count; ++i) {
+        samples[i] *= start_gain + step * static_cast<float>(i + 1);
+    }
+    // computed separately so rounding in the steps never leaves the ramp short of its target
+    if (i < count) {
+        samples[i] *= end_gain;
+    }
+}
+
+/**
+ * @brief Accumulates source into destination, ie destination += source.
+ */
+inline void accumulate(float *destination, const float *source, std::size_t count) {
+    std::size_t i = 0;
+#ifdef INPUT_GRAPHICS_SOUND_MENU_USE_SSE
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(destination + i, _mm_add_ps(_mm_loadu_ps(destination + i), _mm_loadu_ps(source + i)));
+    }
+#endif
+    for (; i < count; ++i) {
+        destination[i] += source[i];
+    }
+}
+
+} // namespace sound_bus_kernels
+
+/**
+ * @class SettingsSnapshotPublisher
+ * @brief Lets one writer thread publish versions of a settings struct that any amount of reader threads can copy
+ * without taking a lock.
+ *
+ * Every version is written to the next slot of a small ring, each slot guarded by its own sequence counter (a
+ * seqlock). A reader copies the latest slot and checks its sequence did not move while copying, so readers never block
+ * the writer or each other. A reader only has to retry if the writer publishes more versions than there are slots
+ * during a single copy, which can't happen at the rate settings are edited.
+ *
+ * The settings are stored as atomic words and copied word by word with relaxed loads and stores, so a reader racing
+ * the writer sees torn data it then throws away instead of undefined behaviour.
+ *
+ * @note only one thread may call publish.
+ */
+template <typename Settings, std::size_t num_slots = 8> class SettingsSnapshotPublisher {
+    static_assert(std::is_trivially_copyable_v<Settings>, "settings are copied byte for byte between threads");
+
+  public:
+    struct VersionedSettings {
+        Settings settings;
+        uint64_t version;
+    };
+
+    void publish(const Settings &settings) {
+        uint64_t version = latest_version.load(std::memory_order_relaxed) + 1;
+        Slot &slot = slots[version % num_slots];
+        Words words = {};
+        std::memcpy(words.data(), &settings, sizeof(Settings));
+        // an odd sequence marks the slot as being written
+        slot.sequence.store(2 * version - 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < num_words; ++i) {
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+        }
+        slot.sequence.store(2 * version, std::memory_order_release);
+        latest_version.store(version, std::memory_order_release);
+    }
+
+    /**
+     * @return a copy of the latest settings along with their version, version 0 means nothing was published yet
+     */
+    VersionedSettings read() const {
+        while (true) {
+            uint64_t version = latest_version.load(std::memory_order_acquire);
+            const Slot &slot = slots[version % num_slots];
+            uint64_t sequence_before = slot.sequence.load(std::memory_order_acquire);
+            Words words;
+            for (std::size_t i = 0; i < num_words; ++i) {
+                words[i] = slot.words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_before == 2 * version && slot.sequence.load(std::memory_order_relaxed) == sequence_before) {
+                VersionedSettings result;
+                std::memcpy(&result.settings, words.data(), sizeof(Settings));
+                result.version = version;
+                return result;
+            }
+        }
+    }
+
+    /**
+     * @brief The latest version, compare it against the one from your last read to skip copying unchanged settings.
+     */
+    uint64_t get_version() const { return latest_version.load(std::memory_order_acquire); }
+
+  private:
+    static constexpr std::size_t num_words = (sizeof(Settings) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    using Words = std::array<uint64_t, num_words>;
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> sequence = 0;
+        std::array<std::atomic<uint64_t>, num_words> words = {};
+    };
+
+    std::array<Slot, num_slots> slots;
+    std::atomic<uint64_t> latest_version = 0;
+};
+
+/**
+ * @class SoundBusMixer
+ * @brief Mixes voices into per-bus buffers and applies the bus gains chosen in the sound settings.
+ *
+ * Gains are only ever changed through set_bus_gain which sets a target, the actual gain then ramps to that target
+ * over the next mixed block so that moving a volume setting never produces a click.
+ *
+ * set_bus_gain and the getters belong to the thread that edits the settings, mix to the audio thread. The gains are
+ * handed over through a SettingsSnapshotPublisher, so neither thread waits on the other and mix never allocates.
+ */
+class SoundBusMixer {
+  public:
+    static constexpr std::size_t num_buses = static_cast<std::size_t>(SoundBus::COUNT);
+    static constexpr std::size_t default_max_block_frames = 4096;
+
+    SoundBusMixer() {
+        configure(default_max_block_frames);
+        published_gains.publish(target_gains);
+    }
+
+    /**
+     * @brief Sizes the bus buffers for the largest block mix will be given, larger blocks are mixed in pieces.
+     *
+     * @note call this before the audio thread starts mixing, it is the only place the buffers are allocated.
+     */
+    void configure(std::size_t max_block_frames) {
+        for (auto &bus_buffer : bus_buffers) {
+            bus_buffer.assign(std::max<std::size_t>(max_block_frames, 1), 0.0f);
+        }
+    }
+
+    /**
+     * @param gain a linear gain, clamped to [0, 1]
+     */
+    void set_bus_gain(SoundBus bus, float gain) {
+        target_gains[static_cast<std::size_t>(bus)] = std::clamp(gain, 0.0f, 1.0f);
+        published_gains.publish(target_gains);
+    }
+
+    float get_bus_gain(SoundBus bus) const { return target_gains[static_cast<std::size_t>(bus)]; }
+
+    /**
+     * @brief The gain a voice on the given bus is heard at once master has been taken into account.
+     */
+    float get_effective_gain(SoundBus bus) const {
+        if (bus == SoundBus::MASTER) {
+            return get_bus_gain(SoundBus::MASTER);
+        }
+        return get_bus_gain(SoundBus::MASTER) * get_bus_gain(bus);
+    }
+
+    /**
+     * @brief Mixes a block of mono voices into output.
+     *
+     * @param voices pointers to num_frames samples for each voice
+     * @param voice_buses the bus each voice is routed through, must be the same size as voices
+     * @param output receives num_frames mixed samples, overwritten
+     */
+    void mix(const std::vector<const float *> &voices, const std::vector<SoundBus> &voice_buses, float *output,
+             std::size_t num_frames) {
+        if (published_gains.get_version() != mixed_gains_version) {
+            auto latest_gains = published_gains.read();
+            mixed_target_gains = latest_gains.settings;
+            mixed_gains_version = latest_gains.version;
+        }
+
+        const std::size_t max_block_frames = bus_buffers[0].size();
+        for (std::size_t offset = 0; offset < num_frames; offset += max_block_frames) {
+            std::size_t block_frames = std::min(max_block_frames, num_frames - offset);
+            for (auto &bus_buffer : bus_buffers) {
+                std::fill(bus_buffer.begin(), bus_buffer.begin() + block_frames, 0.0f);
+            }
+
+            for (std::size_t v = 0; v < voices.size(); ++v) {
+                sound_bus_kernels::accumulate(bus_buffers[static_cast<std::size_t>(voice_buses[v])].data(),
+                                              voices[v] + offset, block_frames);
+            }
+
+            float *block_output = output + offset;
+            std::fill(block_output, block_output + block_frames, 0.0f);
+            const std::size_t master = static_cast<std::size_t>(SoundBus::MASTER);
+            for (std::size_t bus = 0; bus < num_buses; ++bus) {
+                const float target = bus == master ? mixed_target_gains[master]
+                                                   : mixed_target_gains[master] * mixed_target_gains[bus];
+                sound_bus_kernels::apply_gain_ramp(bus_buffers[bus].data(), block_frames, current_gains[bus], target);
+                current_gains[bus] = target;
+                sound_bus_kernels::accumulate(block_output, bus_buffers[bus].data(), block_frames);
+            }
+        }
+    }
+
+    /**
+     * @brief Measures how many voice frames per second this mixer can produce.
+     *
+     * @param num_voices the amount of simultaneous voices to mix, they are spread evenly across the non master buses
+     * @param num_frames the block size used for each mix call
+     * @param num_blocks how many blocks are mixed during the measurement
+     * @return voice frames mixed per second
+     */
+    static double benchmark_mixing_throughput(std::size_t num_voices = 128, std::size_t num_frames = 512,
+                                              std::size_t num_blocks = 1000) {
+        SoundBusMixer mixer;
+        std::vector<std::vector<float>> voice_data(num_voices, std::vector<float>(num_frames));
+        std::vector<const float *> voices;
+        std::vector<SoundBus> voice_buses;
+        for (std::size_t v = 0; v < num_voices; ++v) {
+            for (std::size_t i = 0; i < num_frames; ++i) {
+                voice_data[v][i] = static_cast<float>((v * 31 + i * 17) % 200) / 100.0f - 1.0f;
+            }
+            voices.push_back(voice_data[v].data());
+            voice_buses.push_back(static_cast<SoundBus>(1 + v % (num_buses - 1)));
+        }
+        std::vector<float> output(num_frames);
+
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t block = 0; block < num_blocks; ++block) {
+            // alternating the gain forces the ramp kernel to run every block, which is the worst case
+            mixer.set_bus_gain(SoundBus::MASTER, block % 2 == 0 ? 1.0f : 0.5f);
+            mixer.mix(voices, voice_buses, output.data(), num_frames);
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        return static_cast<double>(num_voices * num_frames * num_blocks) / elapsed.count();
+    }
+
+  private:
+    using Gains = std::array<float, num_buses>;
+
+    // owned by the thread editing the settings
+    Gains target_gains = {1.0f, 1.0f, 1.0f, 1.0f};
+    SettingsSnapshotPublisher<Gains> published_gains;
+
+    // owned by the audio thread
+    Gains mixed_target_gains = {1.0f, 1.0f, 1.0f, 1.0f};
+    uint64_t mixed_gains_version = 0;
+    Gains current_gains = {1.0f, 1.0f, 1.0f, 1.0f};
+    std::array<std::vector<float>, num_buses> bus_buffers;
+};
+
+/**
+ * @brief Describes an audio output device as reported by an IAudioBackend.
+ */
+struct AudioDeviceInfo {
+    std::string name;
+    std::vector<unsigned int> supported_sample_rates;
+};
+
+/**
+ * @brief The parameters of the output path, a smaller buffer lowers latency but makes underruns more likely.
+ */
+struct AudioOutputConfig {
+    std::string device_name = "default";
+    unsigned int sample_rate = 48000;
+    unsigned int buffer_frames = 512;
+};
+
+/**
+ * @brief A view of a fully decoded sound that lives in a ResidentSoundPool.
+ */
+struct ResidentSound {
+    const float *samples = nullptr; // interleaved
+    std::size_t num_frames = 0;
+    unsigned int num_channels = 1;
+    unsigned int sample_rate = 48000;
+};
+
+/**
+ * @class IAudioBackend
+ * @brief The interface the menu uses to enumerate and reconfigure the audio output.
+ *
+ * Implement this on top of whatever owns the audio device (usually the SoundSystem) so that output changes made in
+ * the sound settings can be applied without restarting the program.
+ */
+class IAudioBackend {
+  public:
+    virtual ~IAudioBackend() = default;
+
+    virtual std::vector<AudioDeviceInfo> enumerate_devices() = 0;
+
+    /**
+     * @brief Re-opens the output path with the given config.
+     *
+     * @return true if the config was applied, false if the backend kept its previous config.
+     */
+    virtual bool reconfigure(const AudioOutputConfig &config) = 0;
+
+    virtual unsigned int get_underrun_count() const = 0;
+
+    /**
+     * @brief The latency measured from submitting a buffer to it being played, in milliseconds.
+     */
+    virtual double get_output_latency_ms() const = 0;
+
+    /**
+     * @brief Plays an already decoded sound on a dedicated short latency voice, bypassing any queue.
+     *
+     * @param requested_at when the sound was asked for, used to measure the time until its first sample is output.
+     * @return false if the backend has no such voice path, in which case the caller falls back to the SoundSystem.
+     */
+    virtual bool play_resident(const ResidentSound & /*sound*/, float /*gain*/,
+                               std::chrono::steady_clock::time_point /*requested_at*/) {
+        return false;
+    }
+
+    /**
+     * @brief The time from the last play_resident request until its first sample was output, in milliseconds, or a
+     * negative value if nothing has been measured yet.
+     */
+    virtual double get_resident_playback_latency_ms() const { return -1; }
+
+    /**
+     * @brief Applies a bus gain to everything the backend plays on that bus, the SoundSystem's music and effects
+     * included, called whenever a bus volume changes.
+     *
+     * @param effective_gain the bus gain already multiplied by the master gain
+     * @note the menu mixes only its own ui sounds, a backend that doesn't override this leaves the other buses at full
+     * volume.
+     */
+    virtual void set_bus_gain(SoundBus /*bus*/, float /*effective_gain*/) {}
+};
+
+/**
+ * @class NullAudioBackend
+ * @brief An IAudioBackend which has a single device and never produces sound, used when no backend is given and
+ *        for testing the sound settings without an audio device.
+ */
+class NullAudioBackend : public IAudioBackend {
+  public:
+    std::vector<AudioDeviceInfo> devices = {{"default", {44100, 48000, 96000}}};
+    AudioOutputConfig current_config;
+    unsigned int underrun_count = 0;
+    unsigned int num_enumerations = 0;
+    unsigned int num_reconfigurations = 0;
+
+    std::vector<AudioDeviceInfo> enumerate_devices() override {
+        num_enumerations++;
+        return devices;
+    }
+
+    bool reconfigure(const AudioOutputConfig &config) override {
+        num_reconfigurations++;
+        current_config = config;
+        return true;
+    }
+
+    unsigned int get_underrun_count() const override { return underrun_count; }
+
+    double get_output_latency_ms() const override {
+        return 1000.0 * current_config.buffer_frames / current_config.sample_rate;
+    }
+
+    // play_resident is left alone, there is no voice to play on so resident ui sounds go through the SoundSystem
+};
+
+/**
+ * @class ResidentSoundPool
+ * @brief Holds decoded PCM for a handful of short sounds in a single contiguous block which is never reallocated.
+ *
+ * The block is locked into memory where the platform allows it so that playing a resident sound never page faults,
+ * this is used for ui sounds where any delay between a click and its sound is noticeable.
+ */
+class ResidentSoundPool {
+  public:
+    ResidentSoundPool() = default;
+    ResidentSoundPool(const ResidentSoundPool &) = delete;
+    ResidentSoundPool &operator=(const ResidentSoundPool &) = delete;
+
+    ~ResidentSoundPool() { unpin(); }
+
+    /**
+     * @brief Decodes every wav file and stores it in the pool, any sounds loaded previously are dropped.
+     *
+     * @return the sound types that could not be loaded
+     */
+    std::vector<SoundType> load(const std::unordered_map<SoundType, std::string> &sound_type_to_file) {
+        unpin();
+        sounds.clear();
+        samples.clear();
+
+        std::vector<SoundType> failed;
+        std::vector<std::pair<SoundType, DecodedWav>> decoded;
+        std::size_t total_samples = 0;
+        for (const auto &[sound_type, file_path] : sound_type_to_file) {
+            std::optional<DecodedWav> wav = decode_wav(file_path);
+            if (!wav.has_value()) {
+                failed.push_back(sound_type);
+                continue;
+            }
+            total_samples += wav->samples.size();
+            decoded.emplace_back(sound_type, std::move(wav.value()));
+        }
+
+        // reserving everything up front guarantees the pointers handed out below stay valid
+        samples.reserve(total_samples);
+        for (auto &[sound_type, wav] : decoded) {
+            ResidentSound sound;
+            sound.num_channels = wav.num_channels;
+            sound.sample_rate = wav.sample_rate;
+            sound.num_frames = wav.samples.size() / wav.num_channels;
+            sound.samples = samples.data() + samples.size();
+            samples.insert(samples.end(), wav.samples.begin(), wav.samples.end());
+            sounds[sound_type] = sound;
+        }
+
+        pin();
+        return failed;
+    }
+
+    const ResidentSound *get(SoundType sound_type) const {
+        auto it = sounds.find(sound_type);
+        return it == sounds.end() ? nullptr : &it->second;
+    }
+
+  private:
+    struct DecodedWav {
+        unsigned int num_channels;
+        unsigned int sample_rate;
+        std::vector<float> samples;
+    };
+
+    /**
+     * @brief Decodes a 16 bit integer or 32 bit float pcm wav file into floats.
+     */
+    static std::optional<DecodedWav> decode_wav(const std::string &file_path) {
+        std::ifstream file(file_path, std::ios::binary);
+        if (!file) {
+            return std::nullopt;
+        }
+        std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        auto read_u16 = [&](std::size_t offset) {
+            return static_cast<uint16_t>(static_cast<uint8_t>(bytes[offset]) |
+                                         (static_cast<uint8_t>(bytes[offset + 1]) << 8));
+        };
+        auto read_u32 = [&](std::size_t offset) {
+            return static_cast<uint32_t>(read_u16(offset)) | (static_cast<uint32_t>(read_u16(offset + 2)) << 16);
+        };
+
+        if (bytes.size() < 12 || std::string(bytes.data(), 4) != "RIFF" || std::string(bytes.data() + 8, 4) != "WAVE") {
+            return std::nullopt;
+        }
+
+        uint16_t format = 0, num_channels = 0, bits_per_sample = 0;
+        uint32_t sample_rate = 0;
+        std::size_t offset = 12;
+        while (offset + 8 <= bytes.size()) {
+            std::string chunk_id(bytes.data() + offset, 4);
+            std::size_t chunk_size = read_u32(offset + 4);
+            std::size_t chunk_start = offset + 8;
+            if (chunk_start + chunk_size > bytes.size()) {
+                return std::nullopt;
+            }
+
+            if (chunk_id == "fmt " && chunk_size >= 16) {
+                format = read_u16(chunk_start);
+                num_channels = read_u16(chunk_start + 2);
+                sample_rate = read_u32(chunk_start + 4);
+                bits_per_sample = read_u16(chunk_start + 14);
+            } else if (chunk_id == "data" && num_channels != 0) {
+                DecodedWav wav{num_channels, sample_rate, {}};
+                const bool is_pcm16 = format == 1 && bits_per_sample == 16;
+                const bool is_float32 = format == 3 && bits_per_sample == 32;
+                if (is_pcm16) {
+                    wav.samples.resize(chunk_size / 2);
+                    for (std::size_t i = 0; i < wav.samples.size(); ++i) {
+                        wav.samples[i] = static_cast<int16_t>(read_u16(chunk_start + 2 * i)) / 32768.0f;
+                    }
+                } else if (is_float32) {
+                    wav.samples.resize(chunk_size / 4);
+                    std::memcpy(wav.samples.data(), bytes.data() + chunk_start, wav.samples.size() * 4);
+                } else {
+                    return std::nullopt;
+                }
+                return wav;
+            }
+            // chunks are padded to an even size
+            offset = chunk_start + chunk_size + (chunk_size % 2);
+        }
+        return std::nullopt;
+    }
+
+    void pin() {
+#if defined(__linux__) || defined(__APPLE__)
+        if (!samples.empty()) {
+            pinned = mlock(samples.data(), samples.size() * sizeof(float)) == 0;
+        }
+#endif
+    }
+
+    void unpin() {
+#if defined(__linux__) || defined(__APPLE__)
+        if (pinned) {
+            munlock(samples.data(), samples.size() * sizeof(float));
+        }
+#endif
+        pinned = false;
+    }
+
+    std::vector<float> samples;
+    std::unordered_map<SoundType, ResidentSound> sounds;
+    bool pinned = false;
+};
+
+/**
+ * @class AudioDeviceCache
+ * @brief Caches the result of enumerating devices because doing so can take a long time on some platforms.
+ */
+class AudioDeviceCache {
+  public:
+    explicit AudioDeviceCache(IAudioBackend &audio_backend) : audio_backend(audio_backend) {}
+
+    const std::vector<AudioDeviceInfo> &get_devices() {
+        if (!devices.has_value()) {
+            devices = audio_backend.enumerate_devices();
+        }
+        return devices.value();
+    }
+
+    /**
+     * @brief Forces the next get_devices call to enumerate again, call this when a device is plugged in or removed.
+     */
+    void invalidate() { devices.reset(); }
+
+  private:
+    IAudioBackend &audio_backend;
+    std::optional<std::vector<AudioDeviceInfo>> devices;
+};
+
+/**
+ * @brief The gameplay actions that can be bound to a key in the input settings.
+ *
+ * @note COUNT is only used for sizing arrays.
+ */
+enum class InputAction : uint8_t {
+    FIRE,
+    JUMP,
+    MOVE_FORWARD,
+    MOVE_BACKWARD,
+    MOVE_LEFT,
+    MOVE_RIGHT,
+    MOVE_UP,
+    MOVE_DOWN,
+    SLOW_MOVE,
+    FAST_MOVE,
+
+    COUNT,
+};
+
+/**
+ * @brief A key pressed while holding zero or more modifier keys, eg left_control+w.
+ *
+ * @note modifiers are kept sorted so that two chords with the same keys compare equal.
+ */
+struct KeyChord {
+    std::vector<EKey> modifiers;
+    EKey key;
+
+    KeyChord(EKey key, std::vector<EKey> modifiers = {}) : modifiers(std::move(modifiers)), key(key) {
+        std::sort(this->modifiers.begin(), this->modifiers.end());
+        this->modifiers.erase(std::unique(this->modifiers.begin(), this->modifiers.end()), this->modifiers.end());
+    }
+
+    bool operator==(const KeyChord &other) const { return key == other.key && modifiers == other.modifiers; }
+};
+
+struct KeyChordHash {
+    std::size_t operator()(const KeyChord &chord) const {
+        std::size_t hash = static_cast<std::size_t>(chord.key);
+        for (const auto &modifier : chord.modifiers) {
+            hash = hash * 31 + static_cast<std::size_t>(modifier) + 1;
+        }
+        return hash;
+    }
+};
+
+/**
+ * @class InputBindingTable
+ * @brief The key bindings from the config compiled into flat tables for gameplay code.
+ *
+ * Each action can have any amount of chords bound to it. Plain single key bindings are also stored in a flat EKey to
+ * InputAction array. Chords are matched by update which is a small state machine: every trigger key indexes the chords
+ * it ends, ordered most specific first, so a tick only costs work proportional to the keys that are held.
+ *
+ * All compilation happens when bindings change, nothing here touches strings.
+ */
+class InputBindingTable {
+  public:
+    static constexpr std::size_t num_actions = static_cast<std::size_t>(InputAction::COUNT);
+    static constexpr uint8_t no_action = 0xFF;
+    // a modifier mask is a uint64_t so this is the amount of distinct modifier keys that can appear in chords
+    static constexpr std::size_t max_modifier_keys = 64;
+
+    /**
+     * @brief Rebuilds all tables, only needs to be called when a binding changes.
+     *
+     * @param action_to_chords the chords bound to each action, actions without chords are left unbound
+     * @return false if the same chord was bound to two different actions, the later one is ignored in that case
+     */
+    bool compile(const std::array<std::vector<KeyChord>, num_actions> &action_to_chords) {
+        this->action_to_chords = action_to_chords;
+        chord_to_action.clear();
+        modifier_keys.clear();
+        triggers.clear();
+
+        bool conflict_free = true;
+        std::size_t table_size = 0;
+        for (std::size_t action = 0; action < num_actions; ++action) {
+            for (const auto &chord : action_to_chords[action]) {
+                auto [it, inserted] = chord_to_action.emplace(chord, static_cast<InputAction>(action));
+                if (!inserted && it->second != static_cast<InputAction>(action)) {
+                    conflict_free = false;
+                    continue;
+                }
+                table_size = std::max(table_size, static_cast<std::size_t>(chord.key) + 1);
+                for (const auto &modifier : chord.modifiers) {
+                    table_size = std::max(table_size, static_cast<std::size_t>(modifier) + 1);
+                    if (std::find(modifier_keys.begin(), modifier_keys.end(), modifier) == modifier_keys.end() &&
+                        modifier_keys.size() < max_modifier_keys) {
+                        modifier_keys.push_back(modifier);
+                    }
+                }
+            }
+        }
+
+        key_to_action.assign(table_size, no_action);
+        key_to_modifier_bit.assign(table_size, -1);
+        key_to_trigger_range.assign(table_size, {0, 0});
+
+        for (std::size_t bit = 0; bit < modifier_keys.size(); ++bit) {
+            key_to_modifier_bit[static_cast<std::size_t>(modifier_keys[bit])] = static_cast<int8_t>(bit);
+        }
+
+        for (const auto &[chord, action] : chord_to_action) {
+            if (chord.modifiers.empty()) {
+                key_to_action[static_cast<std::size_t>(chord.key)] = static_cast<uint8_t>(action);
+            }
+            uint64_t modifier_mask = 0;
+            for (const auto &modifier : chord.modifiers) {
+                int8_t bit = key_to_modifier_bit[static_cast<std::size_t>(modifier)];
+                modifier_mask |= bit >= 0 ? uint64_t(1) << bit : 0;
+            }
+            triggers.push_back({chord.key, modifier_mask, action});
+        }
+
+        // group the triggers by key with the chords using the most modifiers first, so the most specific chord wins
+        std::sort(triggers.begin(), triggers.end(), [](const Trigger &a, const Trigger &b) {
+            if (a.key != b.key) {
+                return a.key < b.key;
+            }
+            return std::bitset<64>(a.modifier_mask).count() > std::bitset<64>(b.modifier_mask).count();
+        });
+        for (std::size_t i = 0; i < triggers.size(); ++i) {
+            auto &range = key_to_trigger_range[static_cast<std::size_t>(triggers[i].key)];
+            if (range.second == 0) {
+                range.first = static_cast<uint32_t>(i);
+            }
+            range.second = static_cast<uint32_t>(i + 1);
+        }
+
+        bound_keys.clear();
+        for (std::size_t idx = 0; idx < table_size; ++idx) {
+            if (key_to_trigger_range[idx].second != 0 || key_to_modifier_bit[idx] >= 0) {
+                bound_keys.push_back(static_cast<EKey>(idx));
+            }
+        }
+
+        active_actions.reset();
+        just_activated_actions.reset();
+        return conflict_free;
+    }
+
+    /**
+     * @brief Finds the action a chord is already bound to, used to detect conflicts when a binding is entered.
+     *
+     * @param ignored_action an action that doesn't count as a conflict, usually the one being rebound
+     * @return the conflicting action or std::nullopt if the chord is free
+     */
+    std::optional<InputAction> find_conflict(const KeyChord &chord,
+                                             std::optional<InputAction> ignored_action = std::nullopt) const {
+        auto it = chord_to_action.find(chord);
+        if (it == chord_to_action.end() || it->second == ignored_action) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    /**
+     * @return the action bound to the key on its own, or std::nullopt if the key isn't bound without modifiers
+     */
+    std::optional<InputAction> get_action(EKey key) const {
+        std::size_t idx = static_cast<std::size_t>(key);
+        if (idx >= key_to_action.size() || key_to_action[idx] == no_action) {
+            return std::nullopt;
+        }
+        return static_cast<InputAction>(key_to_action[idx]);
+    }
+
+    const std::vector<KeyChord> &get_chords(InputAction action) const {
+        return action_to_chords[static_cast<std::size_t>(action)];
+    }
+
+    /**
+     * @brief Advances the chord state machine by one tick.
+     *
+     * @param held_keys every key that is currently held down
+     */
+    void update(const std::vector<EKey> &held_keys) {
+        uint64_t held_modifiers = 0;
+        for (const auto &key : held_keys) {
+            std::size_t idx = static_cast<std::size_t>(key);
+            if (idx < key_to_modifier_bit.size() && key_to_modifier_bit[idx] >= 0) {
+                held_modifiers |= uint64_t(1) << key_to_modifier_bit[idx];
+            }
+        }
+
+        std::bitset<num_actions> now_active;
+        for (const auto &key : held_keys) {
+            std::size_t idx = static_cast<std::size_t>(key);
+            if (idx >= key_to_trigger_range.size()) {
+                continue;
+            }
+            auto [begin, end] = key_to_trigger_range[idx];
+            for (uint32_t i = begin; i < end; ++i) {
+                if ((triggers[i].modifier_mask & held_modifiers) == triggers[i].modifier_mask) {
+                    now_active.set(static_cast<std::size_t>(triggers[i].action));
+                    break;
+                }
+            }
+        }
+
+        just_activated_actions = now_active & ~active_actions;
+        active_actions = now_active;
+    }
+
+    /**
+     * @brief Advances the chord state machine using the keys held in the input state.
+     *
+     * @note only the keys that appear in a binding are checked, so a tick costs the amount of bound keys.
+     */
+    void update(InputState &input_state) {
+        held_keys_scratch.clear();
+        for (const auto &key : bound_keys) {
+            if (input_state.is_pressed(key)) {
+                held_keys_scratch.push_back(key);
+            }
+        }
+        update(held_keys_scratch);
+    }
+
+    bool is_action_active(InputAction action) const { return active_actions.test(static_cast<std::size_t>(action)); }
+
+    bool is_action_just_activated(InputAction action) const {
+        return just_activated_actions.test(static_cast<std::size_t>(action));
+    }
+
+  private:
+    struct Trigger {
+        EKey key;
+        uint64_t modifier_mask;
+        InputAction action;
+    };
+
+    std::array<std::vector<KeyChord>, num_actions> action_to_chords;
+    std::unordered_map<KeyChord, InputAction, KeyChordHash> chord_to_action;
+
+    std::vector<EKey> modifier_keys;
+    std::vector<uint8_t> key_to_action;
+    std::vector<int8_t> key_to_modifier_bit;
+    std::vector<std::pair<uint32_t, uint32_t>> key_to_trigger_range;
+    std::vector<Trigger> triggers;
+    // every key that triggers a chord or is a modifier in one, the only keys update polls
+    std::vector<EKey> bound_keys;
+
+    std::bitset<num_actions> active_actions, just_activated_actions;
+    std::vector<EKey> held_keys_scratch;
+};
+
+enum class SensitivityCurveType {
+    LINEAR,
+    POWER,
+    CUSTOM,
+};
+
+/**
+ * @class MouseSensitivityCurve
+ * @brief Turns raw mouse deltas into view deltas using a curve that is compiled into a lookup table.
+ *
+ * The table stores the gain for evenly spaced input speeds, transforming a delta is then a clamp, an index and a lerp
+ * with no branches, which keeps it cheap even with a mouse polling at 8khz. Speeds past the end of the table use the
+ * last gain.
+ */
+class MouseSensitivityCurve {
+  public:
+    static constexpr std::size_t table_size = 256;
+
+    /**
+     * @brief Rebuilds the lookup table, only needs to be called when a setting changes.
+     *
+     * @param exponent used by POWER, the output speed is input_speed ^ exponent
+     * @param custom_points used by CUSTOM, (input speed, gain) pairs which are linearly interpolated
+     * @param max_input_speed the input speed in counts per event covered by the table
+     */
+    void compile(SensitivityCurveType type, float sensitivity, float x_scale, float y_scale, float exponent = 1,
+                 std::vector<std::pair<float, float>> custom_points = {}, float max_input_speed = 128) {
+        this->x_factor = sensitivity * x_scale;
+        this->y_factor = sensitivity * y_scale;
+        step = max_input_speed / static_cast<float>(table_size - 1);
+        inverse_step = 1.0f / step;
+        std::sort(custom_points.begin(), custom_points.end());
+
+        for (std::size_t i = 0; i < table_size; ++i) {
+            // sampling half a step in at zero avoids 0 ^ negative for exponents below one
+            float speed = std::max(static_cast<float>(i), 0.5f) * step;
+            switch (type) {
+            case SensitivityCurveType::LINEAR:
+                gains[i] = 1;
+                break;
+            case SensitivityCurveType::POWER:
+                gains[i] = std::pow(speed, exponent - 1);
+                break;
+            case SensitivityCurveType::CUSTOM:
+                gains[i] = interpolate_custom_points(custom_points, speed);
+                break;
+            }
+        }
+        // lets the lerp read one past the last entry without a branch
+        gains[table_size] = gains[table_size - 1];
+    }
+
+    /**
+     * @brief Transforms a single raw mouse delta into a view delta.
+     */
+    glm::vec2 transform(float delta_x, float delta_y) const {
+        return glm::vec2(delta_x * x_factor * lookup_gain(std::abs(delta_x)),
+                         delta_y * y_factor * lookup_gain(std::abs(delta_y)));
+    }
+
+  private:
+    float lookup_gain(float speed) const {
+        float position = std::min(speed * inverse_step, static_cast<float>(table_size - 1));
+        std::size_t idx = static_cast<std::size_t>(position);
+        float t = position - static_cast<float>(idx);
+        return gains[idx] + (gains[idx + 1] - gains[idx]) * t;
+    }
+
+    static float interpolate_custom_points(const std::vector<std::pair<float, float>> &points, float speed) {
+        if (points.empty()) {
+            return 1;
+        }
+        if (speed <= points.front().first) {
+            return points.front().second;
+        }
+        for (std::size_t i = 1; i < points.size(); ++i) {
+            if (speed <= points[i].first) {
+                const auto &[x0, y0] = points[i - 1];
+                const auto &[x1, y1] = points[i];
+                return x1 == x0 ? y1 : y0 + (y1 - y0) * (speed - x0) / (x1 - x0);
+            }
+        }
+        return points.back().second;
+    }
+
+    std::array<float, table_size + 1> gains = [] {
+        std::array<float, table_size + 1> linear_gains;
+        linear_gains.fill(1);
+        return linear_gains;
+    }();
+    float step = 1, inverse_step = 1;
+    float x_factor = 1, y_factor = 1;
+};
+
+/**
+ * @class GraphicsBenchmark
+ * @brief A short, deterministic cpu workload used to pick graphics settings automatically.
+ *
+ * The workload shades a fixed amount of pseudo pixels (a normalize, a dot product and a clamp each) so that the
+ * score, measured in pixels per second, tracks how quickly this machine can push per pixel work. The workload never
+ * changes between runs, only the time it takes does.
+ */
+class GraphicsBenchmark {
+  public:
+    static constexpr std::size_t num_pixels = 1 << 20;
+    static constexpr int num_runs = 3;
+
+    /**
+     * @return the best pixels per second of a few runs, the best run is the one least disturbed by the os
+     */
+    static double run() {
+        double best_pixels_per_second = 0;
+        for (int run = 0; run < num_runs; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            volatile float sink = shade_pixels();
+            (void)sink;
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best_pixels_per_second = std::max(best_pixels_per_second, num_pixels / elapsed.count());
+        }
+        return best_pixels_per_second;
+    }
+
+    /**
+     * @brief How many benchmark pixels one rendered pixel is worth.
+     *
+     * A benchmark pixel is a single lambert term. A rendered pixel is assumed to be shaded twice (the overdraw of an
+     * opaque scene drawn roughly front to back) and each shading to cost a diffuse and a specular term, so 2 * 2.
+     */
+    static constexpr double rendered_pixel_cost = 4;
+
+    /**
+     * @brief Estimates the time to render one frame at the given resolution from a benchmark score.
+     *
+     * @param pixel_cost how many benchmark pixels one rendered pixel is worth
+     */
+    static double estimate_frame_time_seconds(double pixels_per_second, unsigned int width, unsigned int height,
+                                              double pixel_cost = rendered_pixel_cost) {
+        return pixel_cost * width * height / pixels_per_second;
+    }
+
+  private:
+    static float shade_pixels() {
+        float accumulated = 0;
+        const float light_x = 0.267f, light_y = 0.535f, light_z = 0.802f;
+        for (std::size_t i = 0; i < num_pixels; ++i) {
+            float nx = static_cast<float>(i % 1024) / 512.0f - 1.0f;
+            float ny = static_cast<float>(i / 1024) / 512.0f - 1.0f;
+            float nz = 1.0f;
+            float inverse_length = 1.0f / std::sqrt(nx * nx + ny * ny + nz * nz);
+            float lambert = (nx * light_x + ny * light_y + nz * light_z) * inverse_length;
+            accumulated += std::clamp(lambert, 0.0f, 1.0f);
+        }
+        return accumulated;
+    }
+};
+
+/**
+ * @class DynamicResolutionController
+ * @brief Adjusts the internal render scale from measured frame times to hold a target frame time.
+ *
+ * Frame times are smoothed with an exponential moving average. The scale is lowered as soon as the average has been
+ * over budget for a few frames, but it is only raised after a longer stretch comfortably under budget, and every
+ * change is followed by a cooldown so the new scale can settle. That asymmetry is the hysteresis which stops the
+ * scale from oscillating around the target.
+ */
+class DynamicResolutionController {
+  public:
+    enum class State {
+        STABLE,
+        OVER_BUDGET,
+        UNDER_BUDGET,
+        COOLDOWN,
+    };
+
+    float min_scale = 0.5f, max_scale = 1.0f, scale_step = 0.05f;
+    // the average is considered under budget below this fraction of the target
+    float headroom_fraction = 0.85f;
+    int frames_before_decrease = 5, frames_before_increase = 60, cooldown_frames = 15;
+    double smoothing = 0.1;
+
+    void set_target_frame_time(double seconds) { target_frame_time_seconds = seconds; }
+    double get_target_frame_time() const { return target_frame_time_seconds; }
+
+    /**
+     * @brief Feeds the controller the duration of the last frame.
+     *
+     * @return the render scale to use for the next frame
+     */
+    float update(double frame_time_seconds) {
+        average_frame_time_seconds = average_frame_time_seconds <= 0
+                                         ? frame_time_seconds
+                                         : average_frame_time_seconds +
+                                               smoothing * (frame_time_seconds - average_frame_time_seconds);
+
+        if (state == State::COOLDOWN) {
+            if (--frames_in_state <= 0) {
+                enter_state(State::STABLE);
+            }
+            return scale;
+        }
+
+        if (average_frame_time_seconds > target_frame_time_seconds) {
+            count_frames_in(State::OVER_BUDGET);
+            if (frames_in_state >= frames_before_decrease) {
+                // the rendered pixel count goes with the square of the scale
+                float proportional_scale =
+                    scale * static_cast<float>(std::sqrt(target_frame_time_seconds / average_frame_time_seconds));
+                set_scale_and_cool_down(std::min(proportional_scale, scale - scale_step));
+            }
+        } else if (average_frame_time_seconds < headroom_fraction * target_frame_time_seconds) {
+            count_frames_in(State::UNDER_BUDGET);
+            if (frames_in_state >= frames_before_increase) {
+                set_scale_and_cool_down(scale + scale_step);
+            }
+        } else {
+            enter_state(State::STABLE);
+        }
+        return scale;
+    }
+
+    /**
+     * @brief Drops all history and starts again from the given scale.
+     */
+    void reset(float initial_scale = 1.0f) {
+        scale = std::clamp(initial_scale, min_scale, max_scale);
+        average_frame_time_seconds = 0;
+        enter_state(State::STABLE);
+    }
+
+    float get_scale() const { return scale; }
+    State get_state() const { return state; }
+    double get_average_frame_time() const { return average_frame_time_seconds; }
+
+    static std::string state_to_string(State state) {
+        switch (state) {
+        case State::STABLE:
+            return "stable";
+        case State::OVER_BUDGET:
+            return "over budget";
+        case State::UNDER_BUDGET:
+            return "under budget";
+        case State::COOLDOWN:
+            return "cooldown";
+        }
+        return "unknown";
+    }
+
+  private:
+    void enter_state(State new_state) {
+        state = new_state;
+        frames_in_state = 0;
+    }
+
+    void count_frames_in(State counted_state) {
+        if (state != counted_state) {
+            enter_state(counted_state);
+        }
+        frames_in_state++;
+    }
+
+    void set_scale_and_cool_down(float new_scale) {
+        scale = std::clamp(new_scale, min_scale, max_scale);
+        // the average was measured at the old scale, keeping it would make the next decision off the old frames
+        average_frame_time_seconds = 0;
+        enter_state(State::COOLDOWN);
+        frames_in_state = cooldown_frames;
+    }
+
+    double target_frame_time_seconds = 1.0 / 60.0;
+    double average_frame_time_seconds = 0;
+    float scale = 1.0f;
+    State state = State::STABLE;
+    int frames_in_state = 0;
+};
+
+/**
+ * @class FramePacer
+ * @brief Limits how many frames the gpu can queue up and delays the start of a frame until just before it is needed.
+ *
+ * Both of these trade a little throughput for input latency: fewer queued frames means what is shown is closer to the
+ * latest input, and starting a frame as late as possible means the input it samples is as fresh as possible.
+ *
+ * Call wait_until_frame_start before polling input and on_frame_submitted right after swapping buffers, and
+ * release_fences while the gl context is still current before destroying it.
+ */
+class FramePacer {
+  public:
+    FramePacer() = default;
+    FramePacer(const FramePacer &) = delete;
+    FramePacer &operator=(const FramePacer &) = delete;
+
+    // the fences can't be deleted here since the context may already be gone, they go away along with it
+    ~FramePacer() = default;
+
+    /**
+     * @param enabled when false both calls do nothing
+     * @param max_frames_in_flight how many submitted frames may be unfinished on the gpu at once
+     */
+    void configure(bool enabled, unsigned int max_frames_in_flight = 1) {
+        this->enabled = enabled;
+        this->max_frames_in_flight = std::max(1u, max_frames_in_flight);
+        if (!enabled) {
+            release_fences();
+        }
+    }
+
+    void set_frame_interval(double seconds) { frame_interval_seconds = seconds; }
+
+    bool is_enabled() const { return enabled; }
+
+    /**
+     * @brief Sleeps until the predicted frame work would finish just before the next deadline.
+     */
+    void wait_until_frame_start() {
+        if (!enabled || !last_submit_time.has_value()) {
+            frame_start_time = std::chrono::steady_clock::now();
+            return;
+        }
+        std::chrono::duration<double> lead_time(predicted_frame_work_seconds + safety_margin_seconds);
+        auto deadline = last_submit_time.value() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                       std::chrono::duration<double>(frame_interval_seconds));
+        auto start_at = deadline - std::chrono::duration_cast<std::chrono::steady_clock::duration>(lead_time);
+        if (start_at > std::chrono::steady_clock::now()) {
+            std::this_thread::sleep_until(start_at);
+        }
+        frame_start_time = std::chrono::steady_clock::now();
+    }
+
+    /**
+     * @brief Records the submitted frame and blocks while too many frames are still in flight.
+     */
+    void on_frame_submitted() {
+        auto now = std::chrono::steady_clock::now();
+        if (!enabled) {
+            last_submit_time = now;
+            return;
+        }
+
+        frames_in_flight.push_back(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        while (frames_in_flight.size() > max_frames_in_flight) {
+            GLsync oldest = frames_in_flight.front();
+            frames_in_flight.pop_front();
+            glClientWaitSync(oldest, GL_SYNC_FLUSH_COMMANDS_BIT, fence_timeout_nanoseconds);
+            glDeleteSync(oldest);
+        }
+
+        now = std::chrono::steady_clock::now();
+        std::chrono::duration<double> frame_work = now - frame_start_time;
+        predicted_frame_work_seconds += smoothing * (frame_work.count() - predicted_frame_work_seconds);
+        last_submit_time = now;
+    }
+
+    double get_predicted_frame_work() const { return predicted_frame_work_seconds; }
+
+    /**
+     * @brief Deletes the fences of the frames still in flight, the gl context they were created in must be current.
+     */
+    void release_fences() {
+        for (GLsync fence : frames_in_flight) {
+            glDeleteSync(fence);
+        }
+        frames_in_flight.clear();
+        last_submit_time.reset();
+    }
+
+    double safety_margin_seconds = 0.001;
+    double smoothing = 0.1;
+
+  private:
+    static constexpr GLuint64 fence_timeout_nanoseconds = 100'000'000;
+
+    bool enabled = false;
+    unsigned int max_frames_in_flight = 1;
+    double frame_interval_seconds = 1.0 / 60.0;
+    double predicted_frame_work_seconds = 0;
+    std::deque<GLsync> frames_in_flight;
+    std::chrono::steady_clock::time_point frame_start_time;
+    std::optional<std::chrono::steady_clock::time_point> last_submit_time;
+};
+
+/**
+ * @brief How long a single window mode switch took, along with how many requested changes went into it.
+ */
+struct WindowModeSwitchTiming {
+    std::string resolution;
+    std::string fullscreen;
+    unsigned int num_coalesced_changes;
+    double duration_ms;
+};
+
+/**
+ * @class WindowModeTransaction
+ * @brief Collects resolution and fullscreen changes and applies them together in a single mode switch.
+ *
+ * Changes are staged and only committed once no new change has arrived for the debounce interval, so clicking through
+ * several resolutions quickly only switches the mode once, and changes that end up where they started do nothing.
+ */
+class WindowModeTransaction {
+  public:
+    /**
+     * @param applied_resolution the resolution the window already has, so committing it again does nothing
+     * @param applied_fullscreen whether the window is already fullscreen, "on" or "off"
+     */
+    explicit WindowModeTransaction(Window &window, std::string applied_resolution = "",
+                                   std::string applied_fullscreen = "")
+        : window(window), applied_resolution(std::move(applied_resolution)),
+          applied_fullscreen(std::move(applied_fullscreen)) {}
+
+    std::chrono::milliseconds debounce_interval = std::chrono::milliseconds(250);
+    std::size_t max_timings_kept = 32;
+
+    void stage_resolution(const std::string &resolution) {
+        staged_resolution = resolution;
+        note_staged_change();
+    }
+
+    void stage_fullscreen(const std::string &on_off) {
+        staged_fullscreen = on_off;
+        note_staged_change();
+    }
+
+    bool has_staged_changes() const { return num_staged_changes > 0; }
+
+    /**
+     * @brief Commits the staged changes if the debounce interval has passed since the last one was staged.
+     */
+    void commit_if_settled() {
+        if (has_staged_changes() && std::chrono::steady_clock::now() - last_staged_time >= debounce_interval) {
+            commit();
+        }
+    }
+
+    /**
+     * @brief Applies everything staged so far in one mode switch, regardless of the debounce interval.
+     */
+    void commit() {
+        if (!has_staged_changes()) {
+            return;
+        }
+        unsigned int num_coalesced_changes = num_staged_changes;
+        num_staged_changes = 0;
+
+        std::string resolution = staged_resolution.value_or(applied_resolution);
+        std::string fullscreen = staged_fullscreen.value_or(applied_fullscreen);
+        staged_resolution.reset();
+        staged_fullscreen.reset();
+
+        bool resolution_changed = resolution != applied_resolution;
+        bool fullscreen_changed = fullscreen != applied_fullscreen;
+        if (!resolution_changed && !fullscreen_changed) {
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        if (resolution_changed && fullscreen_changed) {
+            switch_mode_once(resolution, fullscreen);
+        } else if (resolution_changed) {
+            window.set_resolution(resolution);
+        } else {
+            window.set_fullscreen_by_on_off(fullscreen);
+        }
+        std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+
+        applied_resolution = resolution;
+        applied_fullscreen = fullscreen;
+
+        timings.push_back({resolution, fullscreen, num_coalesced_changes, duration.count()});
+        if (timings.size() > max_timings_kept) {
+            timings.pop_front();
+        }
+    }
+
+    /**
+     * @brief The most recent mode switches, oldest first.
+     */
+    const std::deque<WindowModeSwitchTiming> &get_timings() const { return timings; }
+
+  private:
+    void note_staged_change() {
+        num_staged_changes++;
+        last_staged_time = std::chrono::steady_clock::now();
+    }
+
+    /**
+     * @brief Changes the resolution and fullscreen state through the Window, so its stored size and fullscreen state
+     * stay in sync, ordered so that only one of the two calls changes the display mode.
+     *
+     * Going fullscreen the window is resized while still windowed, which is cheap, and then enters fullscreen at the
+     * new size. Leaving fullscreen it first returns to windowed mode and is then resized.
+     */
+    void switch_mode_once(const std::string &resolution, const std::string &fullscreen) {
+        if (fullscreen == "on") {
+            window.set_resolution(resolution);
+            window.set_fullscreen_by_on_off(fullscreen);
+        } else {
+            window.set_fullscreen_by_on_off(fullscreen);
+            window.set_resolution(resolution);
+        }
+    }
+
+    Window &window;
+    std::optional<std::string> staged_resolution, staged_fullscreen;
+    std::string applied_resolution, applied_fullscreen;
+    unsigned int num_staged_changes = 0;
+    std::chrono::steady_clock::time_point last_staged_time;
+    std::deque<WindowModeSwitchTiming> timings;
+};
+
+/**
+ * @class MappedFile
+ * @brief A read only file mapped into memory, on platforms without mmap it is read into memory instead.
+ */
+class MappedFile {
+  public:
+    MappedFile() = default;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept { *this = std::move(other); }
+    MappedFile &operator=(MappedFile &&other) noexcept {
+        if (this != &other) {
+            unmap();
+            mapped_data = std::exchange(other.mapped_data, nullptr);
+            mapped_size = std::exchange(other.mapped_size, 0);
+            fallback_data = std::move(other.fallback_data);
+        }
+        return *this;
+    }
+    ~MappedFile() { unmap(); }
+
+    bool map(const std::string &path) {
+        unmap();
+#if defined(__linux__) || defined(__APPLE__)
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+            close(fd);
+            return false;
+        }
+        void *address = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (address == MAP_FAILED) {
+            return false;
+        }
+        mapped_data = static_cast<const char *>(address);
+        mapped_size = file_stat.st_size;
+        return true;
+#else
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+        fallback_data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return !fallback_data.empty();
+#endif
+    }
+
+    const char *data() const { return mapped_data != nullptr ? mapped_data : fallback_data.data(); }
+    std::size_t size() const { return mapped_data != nullptr ? mapped_size : fallback_data.size(); }
+
+  private:
+    void unmap() {
+#if defined(__linux__) || defined(__APPLE__)
+        if (mapped_data != nullptr) {
+            munmap(const_cast<char *>(mapped_data), mapped_size);
+        }
+#endif
+        mapped_data = nullptr;
+        mapped_size = 0;
+        fallback_data.clear();
+    }
+
+    const char *mapped_data = nullptr;
+    std::size_t mapped_size = 0;
+    std::string fallback_data;
+};
+
+/**
+ * @brief 64 bit FNV-1a, never returns 0 so that 0 can mark an empty slot of a hash table.
+ */
+constexpr uint64_t hash_fnv1a(std::string_view bytes) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : bytes) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    return hash == 0 ? 1 : hash;
+}
+
+/**
+ * @return the modification time of the file at path, 0 if it can't be read
+ */
+inline int64_t get_modification_time(const std::string &path) {
+    std::error_code error;
+    auto time = std::filesystem::last_write_time(path, error);
+    return error ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+/**
+ * @brief Flushes a file or directory to the disk, a no op where there is no fsync.
+ */
+inline void sync_path(const std::string &path) {
+#if defined(__linux__) || defined(__APPLE__)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+#endif
+}
+
+/**
+ * @brief Writes contents to path + ".tmp", syncs it and renames it over path, so a crash leaves either the old or the
+ * new file and never a partial one.
+ */
+inline bool write_file_atomically(const std::string &path, const std::string &contents) {
+    std::string temporary_path = path + ".tmp";
+    {
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+        file.write(contents.data(), contents.size());
+        file.flush();
+        if (!file) {
+            return false;
+        }
+    }
+    sync_path(temporary_path);
+    if (std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+        return false;
+    }
+    // the rename itself is only durable once the directory entry is synced
+    std::filesystem::path parent_path = std::filesystem::path(path).parent_path();
+    sync_path(parent_path.empty() ? "." : parent_path.string());
+    return true;
+}
+
+/**
+ * @brief Config values, section, key and value.
+ */
+using ConfigEntries = std::vector<std::tuple<std::string, std::string, std::string>>;
+
+/**
+ * @brief Config keys, section and key.
+ */
+using ConfigKeys = std::vector<std::pair<std::string, std::string>>;
+
+/**
+ * @brief Reads the given keys from the ini at path with a Configuration, so other inis (profiles, the config file as
+ * it is on disk) are parsed exactly like the live config. Keys the file doesn't set are left out.
+ */
+inline ConfigEntries read_config_values(const std::string &path, const ConfigKeys &keys) {
+    Configuration file_configuration(path);
+    ConfigEntries entries;
+    for (const auto &[section, key] : keys) {
+        if (std::optional<std::string> value = file_configuration.get_value(section, key)) {
+            entries.emplace_back(section, key, std::move(value.value()));
+        }
+    }
+    return entries;
+}
+
+/**
+ * @brief Config values to set, section, key and value, where std::nullopt means the key shouldn't be in the config.
+ */
+using ConfigChanges = std::vector<std::tuple<std::string, std::string, std::optional<std::string>>>;
+
+/**
+ * @brief Identifies a piece of menu text by a hash of its source (english) text, the source is shown when the current
+ * language has no translation for it.
+ *
+ * @note the hash is constexpr so ids of string literals are computed at compile time.
+ */
+struct TextId {
+    template <std::size_t N> constexpr TextId(const char (&source)[N]) : TextId(std::string_view(source, N - 1)) {}
+    // never 0, which marks an empty slot in a LocalizationTable
+    constexpr explicit TextId(std::string_view source) : hash(hash_fnv1a(source)), source(source) {}
+
+    uint64_t hash;
+    std::string_view source;
+};
+
+/**
+ * @class LocalizationTable
+ * @brief The menu text of one language, compiled from a text file into a memory mapped hash table of TextIds.
+ *
+ * The strings file has one translation per line, the source text and its translation separated by a tab, lines
+ * starting with # are comments. The compiled table records the modification time and size of the strings file it was
+ * built from and is rebuilt when either changes, a table shipped without its strings file is used as is.
+ *
+ * Layout: a Header, then table_capacity Slots (open addressing, linear probing), then the translations. Identical
+ * translations are stored once, so every id and every widget showing the same text share the same bytes.
+ */
+class LocalizationTable {
+  public:
+    /**
+     * @brief Parses the strings file at strings_path and writes the compiled table to table_path.
+     */
+    static bool build(const std::string &strings_path, const std::string &table_path) {
+        std::ifstream strings_file(strings_path, std::ios::binary);
+        if (!strings_file) {
+            return false;
+        }
+        std::string contents((std::istreambuf_iterator<char>(strings_file)), std::istreambuf_iterator<char>());
+
+        std::vector<std::pair<std::string, std::string>> translations;
+        std::stringstream stream(contents);
+        std::string line;
+        while (std::getline(stream, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            size_t tab_pos = line.find('\t');
+            if (line.empty() || line[0] == '#' || tab_pos == std::string::npos) {
+                continue;
+            }
+            translations.emplace_back(line.substr(0, tab_pos), line.substr(tab_pos + 1));
+        }
+
+        uint64_t table_capacity = 16;
+        while (table_capacity < translations.size() * 2) {
+            table_capacity *= 2;
+        }
+
+        std::vector<Slot> slots(table_capacity);
+        std::string strings;
+        std::unordered_map<std::string, uint32_t> interned_offsets;
+        for (const auto &[source, translation] : translations) {
+            uint64_t text_id = hash_fnv1a(source);
+            uint64_t idx = text_id & (table_capacity - 1);
+            while (slots[idx].text_id != 0 && slots[idx].text_id != text_id) {
+                idx = (idx + 1) & (table_capacity - 1);
+            }
+            auto [interned, added] = interned_offsets.try_emplace(translation, static_cast<uint32_t>(strings.size()));
+            if (added) {
+                strings += translation;
+            }
+            // later duplicates win
+            slots[idx] = {text_id, interned->second, static_cast<uint32_t>(translation.size())};
+        }
+
+        Header header;
+        header.strings_modification_time = get_modification_time(strings_path);
+        header.strings_size = contents.size();
+        header.table_capacity = table_capacity;
+
+        std::string table(reinterpret_cast<const char *>(&header), sizeof(header));
+        table.append(reinterpret_cast<const char *>(slots.data()), slots.size() * sizeof(Slot));
+        table += strings;
+        return write_file_atomically(table_path, table);
+    }
+
+    /**
+     * @brief Maps the table, if it is missing or was built from an older strings file it is rebuilt first.
+     *
+     * @return the table or std::nullopt if neither loading nor rebuilding worked
+     */
+    static std::optional<LocalizationTable> load_or_build(const std::string &strings_path,
+                                                          const std::string &table_path) {
+        std::optional<LocalizationTable> table = load(strings_path, table_path);
+        if (!table.has_value() && build(strings_path, table_path)) {
+            table = load(strings_path, table_path);
+        }
+        return table;
+    }
+
+    /**
+     * @brief Maps the table if it is valid for the strings file at strings_path, or if that file doesn't exist.
+     *
+     * @note only the modification time and size of the strings file are compared, it is never read here. The table
+     * and every slot are bounds checked, so a truncated or corrupt file is rejected instead of making find read out of
+     * bounds or probe forever.
+     */
+    static std::optional<LocalizationTable> load(const std::string &strings_path, const std::string &table_path) {
+        LocalizationTable table;
+        if (!table.file.map(table_path) || table.file.size() < sizeof(Header)) {
+            return std::nullopt;
+        }
+
+        const Header &header = table.header();
+        Header expected;
+        if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 || header.version != expected.version ||
+            header.table_capacity == 0 || (header.table_capacity & (header.table_capacity - 1)) != 0 ||
+            header.table_capacity > (table.file.size() - sizeof(Header)) / sizeof(Slot)) {
+            return std::nullopt;
+        }
+
+        const Slot *slots = reinterpret_cast<const Slot *>(table.file.data() + sizeof(Header));
+        uint64_t strings_size = table.file.size() - sizeof(Header) - header.table_capacity * sizeof(Slot);
+        bool has_empty_slot = false;
+        for (uint64_t idx = 0; idx < header.table_capacity; ++idx) {
+            const Slot &slot = slots[idx];
+            if (slot.text_id == 0) {
+                has_empty_slot = true;
+                continue;
+            }
+            if (uint64_t(slot.offset) + slot.length > strings_size) {
+                return std::nullopt;
+            }
+        }
+        // find stops probing at an empty slot
+        if (!has_empty_slot) {
+            return std::nullopt;
+        }
+
+        std::error_code error;
+        uintmax_t strings_file_size = std::filesystem::file_size(strings_path, error);
+        if (!error && (header.strings_modification_time != get_modification_time(strings_path) ||
+                       header.strings_size != strings_file_size)) {
+            return std::nullopt;
+        }
+        return table;
+    }
+
+    /**
+     * @return the translation of the text, it points into the mapped table and lives as long as it does
+     */
+    std::optional<std::string_view> find(const TextId &text) const {
+        const Header &header = this->header();
+        const Slot *slots = reinterpret_cast<const Slot *>(file.data() + sizeof(Header));
+        const char *strings = file.data() + sizeof(Header) + header.table_capacity * sizeof(Slot);
+
+        for (uint64_t idx = text.hash & (header.table_capacity - 1);; idx = (idx + 1) & (header.table_capacity - 1)) {
+            const Slot &slot = slots[idx];
+            if (slot.text_id == 0) {
+                return std::nullopt;
+            }
+            if (slot.text_id == text.hash) {
+                return std::string_view(strings + slot.offset, slot.length);
+            }
+        }
+    }
+
+  private:
+    struct Header {
+        char magic[4] = {'I', 'G', 'S', 'L'};
+        uint32_t version = 2;
+        int64_t strings_modification_time = 0;
+        uint64_t strings_size = 0;
+        uint64_t table_capacity = 0;
+    };
+
+    struct Slot {
+        uint64_t text_id = 0; // 0 marks an empty slot
+        uint32_t offset = 0, length = 0;
+    };
+
+    const Header &header() const { return *reinterpret_cast<const Header *>(file.data()); }
+
+    MappedFile file;
+};
+
+/**
+ * @brief The result of parsing the config file after it changed on disk.
+ */
+struct ConfigReload {
+    ConfigEntries entries;
+    double parse_ms;
+};
+
+/**
+ * @brief How long a config reload took to parse and to apply, along with how many values it changed.
+ */
+struct ConfigReloadTiming {
+    double parse_ms;
+    double apply_ms;
+    std::size_t num_changed_values;
+};
+
+/**
+ * @class ConfigFileWatcher
+ * @brief Watches a config file on a background thread and reads it there whenever it changes.
+ *
+ * On linux this uses inotify on the file's directory, which also catches editors that save by replacing the file,
+ * elsewhere it falls back to polling the modification time. Only the latest parse is kept, take it on the main thread
+ * with take_reload.
+ */
+class ConfigFileWatcher {
+  public:
+    /**
+     * @param keys the keys read from the file on every change, the ones the menu handles
+     */
+    ConfigFileWatcher(std::string config_file_path, ConfigKeys keys)
+        : config_file_path(std::move(config_file_path)), keys(std::move(keys)), thread([this] { watch(); }) {}
+
+    ConfigFileWatcher(const ConfigFileWatcher &) = delete;
+    ConfigFileWatcher &operator=(const ConfigFileWatcher &) = delete;
+
+    ~ConfigFileWatcher() {
+        stop_requested = true;
+        thread.join();
+    }
+
+    std::optional<ConfigReload> take_reload() {
+        std::lock_guard<std::mutex> lock(reload_mutex);
+        return std::exchange(pending_reload, std::nullopt);
+    }
+
+  private:
+    static constexpr int poll_interval_ms = 200;
+
+    void parse() {
+        auto start = std::chrono::steady_clock::now();
+        if (!std::filesystem::exists(config_file_path)) {
+            return;
+        }
+        ConfigReload reload{read_config_values(config_file_path, keys), 0};
+        reload.parse_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(reload_mutex);
+        pending_reload = std::move(reload);
+    }
+
+    void watch() {
+        std::filesystem::path path(config_file_path);
+#ifdef __linux__
+        int inotify_fd = inotify_init1(IN_NONBLOCK);
+        std::string directory = path.has_parent_path() ? path.parent_path().string() : ".";
+        if (inotify_fd >= 0 && inotify_add_watch(inotify_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) >= 0) {
+            std::string file_name = path.filename().string();
+            alignas(inotify_event) char buffer[4096];
+            while (!stop_requested) {
+                pollfd poll_fd{inotify_fd, POLLIN, 0};
+                if (poll(&poll_fd, 1, poll_interval_ms) <= 0) {
+                    continue;
+                }
+                bool config_changed = false;
+                ssize_t length;
+                while ((length = read(inotify_fd, buffer, sizeof(buffer))) > 0) {
+                    for (char *ptr = buffer; ptr < buffer + length;) {
+                        auto *event = reinterpret_cast<inotify_event *>(ptr);
+                        config_changed |= event->len > 0 && file_name == event->name;
+                        ptr += sizeof(inotify_event) + event->len;
+                    }
+                }
+                if (config_changed) {
+                    parse();
+                }
+            }
+            close(inotify_fd);
+            return;
+        }
+        if (inotify_fd >= 0) {
+            close(inotify_fd);
+        }
+#endif
+        std::error_code error;
+        auto last_write_time = std::filesystem::last_write_time(path, error);
+        while (!stop_requested) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(poll_interval_ms));
+            auto write_time = std::filesystem::last_write_time(path, error);
+            if (!error && write_time != last_write_time) {
+                last_write_time = write_time;
+                parse();
+            }
+        }
+    }
+
+    std::string config_file_path;
+    ConfigKeys keys;
+    std::atomic<bool> stop_requested = false;
+    std::mutex reload_mutex;
+    std::optional<ConfigReload> pending_reload;
+    // declared last so it starts after everything it uses has been constructed
+    std::thread thread;
+};
+
+/**
+ * @class SettingsJournal
+ * @brief An append only log of config changes that makes every change durable without rewriting the config file.
+ *
+ * append only queues the change, a background thread writes it to the journal file and syncs it. Once enough changes
+ * have piled up the background thread folds them into the ini (written to a temporary file and renamed over it, so a
+ * crash leaves either the old or the new file) and empties the journal. On startup replay applies whatever is left in
+ * the journal, ie the changes made since the last compaction or save.
+ *
+ * Each line of the journal is section, key, value and the key's value in the ini when the line was written, separated
+ * by tabs, with tabs, newlines and backslashes escaped. The ini value is "=" followed by the value, or empty if the key
+ * wasn't in the ini. An entry whose key has since been changed in the ini by something other than the menu (a hand
+ * edit, a hot reload) is stale and is neither replayed nor folded in.
+ *
+ * Compaction and saving the config both rewrite the ini, save through save_config so the two never overlap.
+ */
+class SettingsJournal {
+  public:
+    SettingsJournal(std::string journal_path, std::string config_file_path)
+        : journal_path(std::move(journal_path)), config_file_path(std::move(config_file_path)),
+          thread([this] { write_behind(); }) {}
+
+    SettingsJournal(const SettingsJournal &) = delete;
+    SettingsJournal &operator=(const SettingsJournal &) = delete;
+
+    ~SettingsJournal() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            stop_requested = true;
+        }
+        queue_condition.notify_one();
+        thread.join();
+    }
+
+    std::size_t compaction_threshold = 64;
+
+    /**
+     * @brief Reads the journal left behind by the last run.
+     *
+     * @return the changes in the order they were made, without the stale ones
+     */
+    ConfigEntries read_entries() {
+        std::lock_guard<std::mutex> lock(config_file_mutex);
+        return read_current_entries();
+    }
+
+    /**
+     * @brief Runs save_to_file, which must write the whole config to the ini, without a compaction rewriting the ini
+     * at the same time, and then discards the journal up to this point.
+     */
+    void save_config(const std::function<void()> &save_to_file) {
+        {
+            std::lock_guard<std::mutex> lock(config_file_mutex);
+            save_to_file();
+        }
+        queue_operation(Operation::Type::DISCARD);
+    }
+
+    /**
+     * @brief Queues a change to be written to the journal, this never touches the disk.
+     */
+    void append(const std::string &section, const std::string &key, const std::string &value) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            queue.push_back({Operation::Type::APPEND, section, key, value});
+        }
+        queue_condition.notify_one();
+    }
+
+    /**
+     * @brief Folds the journal into the ini on the background thread.
+     */
+    void request_compaction() { queue_operation(Operation::Type::COMPACT); }
+
+  private:
+    struct Operation {
+        enum class Type { APPEND, DISCARD, COMPACT } type;
+        std::string section, key, value;
+    };
+
+    /**
+     * @param ini the ini read with a Configuration, so the journal sees it the way the live config does
+     */
+    static std::string encode_ini_value(Configuration &ini, const std::string &section, const std::string &key) {
+        std::optional<std::string> value = ini.get_value(section, key);
+        return value.has_value() ? "=" + value.value() : "";
+    }
+
+    /**
+     * @brief Reads the journal, dropping entries whose key changed in the ini since they were written, the caller holds
+     * config_file_mutex.
+     */
+    ConfigEntries read_current_entries() const {
+        Configuration ini(config_file_path);
+        ConfigEntries entries;
+        std::ifstream journal(journal_path);
+        std::string line;
+        while (std::getline(journal, line)) {
+            std::vector<std::string> fields = {""};
+            for (std::size_t i = 0; i < line.size(); ++i) {
+                if (line[i] == '\t') {
+                    fields.emplace_back();
+                } else if (line[i] == '\\' && i + 1 < line.size()) {
+                    char escaped = line[++i];
+                    fields.back() += escaped == 't' ? '\t' : escaped == 'n' ? '\n' : escaped;
+                } else {
+                    fields.back() += line[i];
+                }
+            }
+            // a line cut short by a crash is ignored
+            if (fields.size() != 4) {
+                continue;
+            }
+            if (encode_ini_value(ini, fields[0], fields[1]) != fields[3]) {
+                continue;
+            }
+            entries.emplace_back(fields[0], fields[1], fields[2]);
+        }
+        return entries;
+    }
+
+    static std::string escape(const std::string &str) {
+        std::string escaped;
+        for (char c : str) {
+            if (c == '\t') {
+                escaped += "\\t";
+            } else if (c == '\n') {
+                escaped += "\\n";
+            } else if (c == '\\') {
+                escaped += "\\\\";
+            } else {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    void queue_operation(Operation::Type type) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            queue.push_back({type, "", "", ""});
+        }
+        queue_condition.notify_one();
+    }
+
+    void write_behind() {
+        std::size_t num_journaled = read_entries().size();
+        std::vector<Operation> operations;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                queue_condition.wait(lock, [this] { return stop_requested || !queue.empty(); });
+                if (queue.empty() && stop_requested) {
+                    return;
+                }
+                operations.assign(std::make_move_iterator(queue.begin()), std::make_move_iterator(queue.end()));
+                queue.clear();
+            }
+
+            std::string pending_lines;
+            auto flush_pending_lines = [&] {
+                if (!pending_lines.empty()) {
+                    append_to_journal(pending_lines);
+                    pending_lines.clear();
+                }
+            };
+            std::optional<Configuration> ini;
+            for (const auto &operation : operations) {
+                if (operation.type == Operation::Type::APPEND) {
+                    if (!ini.has_value()) {
+                        std::lock_guard<std::mutex> lock(config_file_mutex);
+                        ini.emplace(config_file_path);
+                    }
+                    pending_lines += escape(operation.section) + '\t' + escape(operation.key) + '\t' +
+                                     escape(operation.value) + '\t' +
+                                     escape(encode_ini_value(ini.value(), operation.section, operation.key)) +
+                                     '\n';
+                    num_journaled++;
+                    continue;
+                }
+                // a save or compaction rewrites the ini, so the values read before it are out of date
+                ini.reset();
+                flush_pending_lines();
+                if (operation.type == Operation::Type::COMPACT && !compact()) {
+                    continue;
+                }
+                truncate_journal();
+                num_journaled = 0;
+            }
+            flush_pending_lines();
+
+            if (num_journaled >= compaction_threshold && compact()) {
+                truncate_journal();
+                num_journaled = 0;
+            }
+        }
+    }
+
+    void append_to_journal(const std::string &lines) {
+#if defined(__linux__) || defined(__APPLE__)
+        int fd = open(journal_path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd < 0) {
+            return;
+        }
+        for (std::size_t written = 0; written < lines.size();) {
+            ssize_t result = write(fd, lines.data() + written, lines.size() - written);
+            if (result <= 0) {
+                break;
+            }
+            written += result;
+        }
+        fsync(fd);
+        close(fd);
+#else
+        std::ofstream journal(journal_path, std::ios::app);
+        journal << lines << std::flush;
+#endif
+    }
+
+    void truncate_journal() { std::ofstream journal(journal_path, std::ios::trunc); }
+
+    /**
+     * @brief Rewrites the ini with the journaled values applied, keeping its comments and ordering.
+     *
+     * @return true if the ini now contains everything in the journal
+     */
+    bool compact() {
+        std::lock_guard<std::mutex> lock(config_file_mutex);
+        ConfigEntries entries = read_current_entries();
+        if (entries.empty()) {
+            return true;
+        }
+
+        std::vector<std::string> lines;
+        {
+            std::ifstream ini(config_file_path);
+            std::string line;
+            while (std::getline(ini, line)) {
+                lines.push_back(line);
+            }
+        }
+
+        auto trim = [](std::string str) {
+            str.erase(0, str.find_first_not_of(" \t\r"));
+            str.erase(str.find_last_not_of(" \t\r") + 1);
+            return str;
+        };
+
+        for (const auto &[section, key, value] : entries) {
+            std::string current_section;
+            std::optional<std::size_t> section_end;
+            bool replaced = false;
+            for (std::size_t i = 0; i < lines.size() && !replaced; ++i) {
+                std::string line = trim(lines[i]);
+                if (!line.empty() && line.front() == '[' && line.back() == ']') {
+                    current_section = trim(line.substr(1, line.size() - 2));
+                } else if (current_section == section && !line.empty() && line[0] != ';' && line[0] != '#' &&
+                           line.find('=') != std::string::npos && trim(line.substr(0, line.find('='))) == key) {
+                    lines[i] = key + " = " + value;
+                    replaced = true;
+                }
+                if (current_section == section) {
+                    section_end = i + 1;
+                }
+            }
+            if (!replaced && section_end.has_value()) {
+                lines.insert(lines.begin() + section_end.value(), key + " = " + value);
+            } else if (!replaced) {
+                lines.push_back("[" + section + "]");
+                lines.push_back(key + " = " + value);
+            }
+        }
+
+        std::string ini;
+        for (const auto &line : lines) {
+            ini += line + '\n';
+        }
+        return write_file_atomically(config_file_path, ini);
+    }
+
+    std::string journal_path, config_file_path;
+    // held while anything reads or rewrites the ini, see save_config
+    mutable std::mutex config_file_mutex;
+    std::mutex queue_mutex;
+    std::condition_variable queue_condition;
+    std::deque<Operation> queue;
+    bool stop_requested = false;
+    // declared last so it starts after everything it uses has been constructed
+    std::thread thread;
+};
+
+/**
+ * @class SettingsProfiles
+ * @brief Named sets of config values (eg benchmark, demo, low_power) layered over the base config.
+ *
+ * A profile only lists the values it overrides. Switching computes the values that actually change between the
+ * active profile and the new one, so only their handlers have to run. The base values a profile covers up, including
+ * the fact that a key wasn't set at all, are remembered so that switching back to the base config ("") restores them.
+ */
+class SettingsProfiles {
+  public:
+    using Values = std::map<std::pair<std::string, std::string>, std::string>; // (section, key) -> value
+    using BaseValues = std::map<std::pair<std::string, std::string>, std::optional<std::string>>;
+    using ValueLookup = std::function<std::optional<std::string>(const std::string &, const std::string &)>;
+
+    // the name the settings menu shows for the base config, so no profile can use it
+    static constexpr const char *base_config_name = "default";
+
+    /**
+     * @return false if the name is reserved for the base config
+     */
+    bool add_profile(const std::string &name, const ConfigEntries &overrides) {
+        if (name.empty() || name == base_config_name) {
+            return false;
+        }
+        Values &values = profiles[name];
+        values.clear();
+        for (const auto &[section, key, value] : overrides) {
+            values[{section, key}] = value;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Adds a profile whose overrides are the values of keys in the ini at ini_path, saving while it is active
+     * writes back to that ini.
+     *
+     * @return false if the ini couldn't be read or the name is reserved for the base config
+     */
+    bool load_profile(const std::string &name, const std::string &ini_path, const ConfigKeys &keys) {
+        if (!std::filesystem::exists(ini_path) || !add_profile(name, read_config_values(ini_path, keys))) {
+            return false;
+        }
+        profile_paths[name] = ini_path;
+        return true;
+    }
+
+    /**
+     * @brief Takes the live values of everything the active profile overrides into it and writes them to the ini it
+     * was loaded from, if any.
+     *
+     * @return false if there is no active profile or writing its ini failed
+     */
+    bool save_active_profile(const ValueLookup &get_current_value) {
+        if (active_profile.empty()) {
+            return false;
+        }
+        Values &values = profiles.at(active_profile);
+        for (auto &[section_key, value] : values) {
+            value = get_current_value(section_key.first, section_key.second).value_or(value);
+        }
+
+        auto path = profile_paths.find(active_profile);
+        if (path == profile_paths.end()) {
+            return true;
+        }
+        std::ofstream file(path->second, std::ios::trunc);
+        std::optional<std::string> section;
+        for (const auto &[section_key, value] : values) {
+            if (section_key.first != section) {
+                section = section_key.first;
+                file << "[" << section_key.first << "]\n";
+            }
+            file << section_key.second << " = " << value << '\n';
+        }
+        return static_cast<bool>(file);
+    }
+
+    /**
+     * @brief The values of the active profile, empty for the base config.
+     */
+    const Values &get_active_values() const {
+        static const Values no_values;
+        return active_profile.empty() ? no_values : profiles.at(active_profile);
+    }
+
+    /**
+     * @brief The base config's values for everything the active profile overrides, std::nullopt where the base config
+     * didn't have the key.
+     */
+    const BaseValues &get_base_values() const { return base_values; }
+
+    std::vector<std::string> get_profile_names() const {
+        std::vector<std::string> names;
+        for (const auto &[name, values] : profiles) {
+            names.push_back(name);
+        }
+        return names;
+    }
+
+    const std::string &get_active_profile() const { return active_profile; }
+
+    /**
+     * @brief Makes name the active profile, "" is the base config.
+     *
+     * @param get_current_value looks up the live value of (section, key)
+     * @return the values that have to be set for the switch, values that already match are left out, empty if there
+     * is no such profile
+     */
+    ConfigChanges switch_to(const std::string &name, const ValueLookup &get_current_value) {
+        ConfigChanges changes;
+        if (!name.empty() && profiles.find(name) == profiles.end()) {
+            return changes;
+        }
+        static const Values no_values;
+        const Values &old_values = active_profile.empty() ? no_values : profiles.at(active_profile);
+        const Values &new_values = name.empty() ? no_values : profiles.at(name);
+
+        auto add_change_if_different = [&](const std::pair<std::string, std::string> &section_key,
+                                           const std::optional<std::string> &value) {
+            if (get_current_value(section_key.first, section_key.second) != value) {
+                changes.emplace_back(section_key.first, section_key.second, value);
+            }
+        };
+
+        // values covered by the old profile but not the new one go back to their base value
+        for (const auto &[section_key, value] : old_values) {
+            if (new_values.find(section_key) != new_values.end()) {
+                continue;
+            }
+            auto base_value = base_values.find(section_key);
+            if (base_value != base_values.end()) {
+                add_change_if_different(section_key, base_value->second);
+                base_values.erase(base_value);
+            }
+        }
+
+        for (const auto &[section_key, value] : new_values) {
+            if (base_values.find(section_key) == base_values.end()) {
+                base_values[section_key] = get_current_value(section_key.first, section_key.second);
+            }
+            add_change_if_different(section_key, value);
+        }
+
+        active_profile = name;
+        return changes;
+    }
+
+  private:
+    std::map<std::string, Values> profiles;
+    std::map<std::string, std::string> profile_paths;
+    BaseValues base_values; // the base config's values for everything the active profile overrides
+    std::string active_profile;
+};
+
+/**
+ * @class PersistentSettingsMap
+ * @brief An immutable (section, key) -> value map where every set returns a new map sharing all but O(log n) nodes
+ * with the old one, so keeping thousands of versions around is cheap.
+ *
+ * It is a treap whose priorities are hashes of the keys, so the shape only depends on the keys it holds and stays
+ * balanced in expectation.
+ */
+class PersistentSettingsMap {
+  public:
+    using Key = std::pair<std::string, std::string>; // section, key
+
+    std::optional<std::string> get(const Key &key) const {
+        const Node *node = root.get();
+        while (node != nullptr) {
+            if (key == node->key) {
+                return node->value;
+            }
+            node = key < node->key ? node->left.get() : node->right.get();
+        }
+        return std::nullopt;
+    }
+
+    [[nodiscard]] PersistentSettingsMap set(const Key &key, const std::string &value) const {
+        PersistentSettingsMap result;
+        result.root = insert(root, key, value, std::hash<std::string>()(key.first + '\n' + key.second));
+        return result;
+    }
+
+  private:
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+    struct Node {
+        Key key;
+        std::string value;
+        std::size_t priority;
+        NodePtr left, right;
+    };
+
+    static NodePtr make_node(const Node &node, NodePtr left, NodePtr right) {
+        return std::make_shared<const Node>(
+            Node{node.key, node.value, node.priority, std::move(left), std::move(right)});
+    }
+
+    // only the nodes on the path to key are copied, everything hanging off that path is shared
+    static NodePtr insert(const NodePtr &node, const Key &key, const std::string &value, std::size_t priority) {
+        if (node == nullptr) {
+            return std::make_shared<const Node>(Node{key, value, priority, nullptr, nullptr});
+        }
+        if (key == node->key) {
+            return std::make_shared<const Node>(Node{key, value, node->priority, node->left, node->right});
+        }
+        if (key < node->key) {
+            NodePtr left = insert(node->left, key, value, priority);
+            if (left->priority > node->priority) {
+                return make_node(*left, left->left, make_node(*node, left->right, node->right));
+            }
+            return make_node(*node, std::move(left), node->right);
+        }
+        NodePtr right = insert(node->right, key, value, priority);
+        if (right->priority > node->priority) {
+            return make_node(*right, make_node(*node, node->left, right->left), right->right);
+        }
+        return make_node(*node, node->left, std::move(right));
+    }
+
+    NodePtr root;
+};
+
+/**
+ * @class SettingsHistory
+ * @brief Undo and redo for settings edits, every step is a version of a PersistentSettingsMap plus the keys it changed.
+ *
+ * Changes are collected with record and grouped into one step by commit_step, so a click that sets several values is
+ * undone as a whole. undo and redo return only the values of the keys the step touched.
+ */
+class SettingsHistory {
+  public:
+    explicit SettingsHistory(std::size_t max_steps = 4096) : max_steps(max_steps) { versions.emplace_back(); }
+
+    /**
+     * @brief Records that key changed from old_value to new_value, it becomes part of the next step.
+     *
+     * @param old_value std::nullopt if the key wasn't in the config, undoing back to it then removes the key again
+     */
+    void record(const PersistentSettingsMap::Key &key, const std::optional<std::string> &old_value,
+                const std::string &new_value) {
+        // the first time a key changes its old value is remembered, versions that don't hold the key had this value
+        initial_values.emplace(key, old_value);
+        pending_values = pending_values.set(key, new_value);
+        if (std::find(pending_keys.begin(), pending_keys.end(), key) == pending_keys.end()) {
+            pending_keys.push_back(key);
+        }
+    }
+
+    /**
+     * @brief Turns the changes recorded since the last step into one undoable step, any redo steps are dropped.
+     */
+    void commit_step() {
+        if (pending_keys.empty()) {
+            return;
+        }
+        versions.resize(current_version + 1);
+        changed_keys.resize(current_version);
+        versions.push_back(pending_values);
+        changed_keys.push_back(std::move(pending_keys));
+        pending_keys.clear();
+        current_version++;
+        if (changed_keys.size() > max_steps) {
+            versions.pop_front();
+            changed_keys.pop_front();
+            current_version--;
+        }
+    }
+
+    bool can_undo() const { return current_version > 0; }
+    bool can_redo() const { return current_version + 1 < versions.size(); }
+
+    /**
+     * @return the values to set to undo the last step, std::nullopt for keys that have to be removed
+     */
+    ConfigChanges undo() {
+        if (!can_undo()) {
+            return {};
+        }
+        const auto &keys = changed_keys[current_version - 1];
+        current_version--;
+        pending_values = versions[current_version];
+        return get_values(keys, versions[current_version]);
+    }
+
+    /**
+     * @return the values to set to redo the last undone step
+     */
+    ConfigChanges redo() {
+        if (!can_redo()) {
+            return {};
+        }
+        current_version++;
+        pending_values = versions[current_version];
+        return get_values(changed_keys[current_version - 1], versions[current_version]);
+    }
+
+  private:
+    ConfigChanges get_values(const std::vector<PersistentSettingsMap::Key> &keys,
+                             const PersistentSettingsMap &version) const {
+        ConfigChanges values;
+        for (const auto &key : keys) {
+            std::optional<std::string> value = version.get(key);
+            values.emplace_back(key.first, key.second, value.has_value() ? value : initial_values.at(key));
+        }
+        return values;
+    }
+
+    std::size_t max_steps;
+    std::deque<PersistentSettingsMap> versions;
+    std::deque<std::vector<PersistentSettingsMap::Key>> changed_keys; // changed_keys[i] took versions[i] to i + 1
+    std::size_t current_version = 0;
+    PersistentSettingsMap pending_values;
+    std::vector<PersistentSettingsMap::Key> pending_keys;
+    std::map<PersistentSettingsMap::Key, std::optional<std::string>> initial_values;
+};
+
+/**
+ * @brief The settings game threads need every tick, already parsed into their final types.
+ */
+struct GameSettings {
+    MouseSensitivityCurve mouse_sensitivity_curve;
+    std::array<float, SoundBusMixer::num_buses> bus_gains = {1, 1, 1, 1};
+    float field_of_view_degrees = 90;
+    float max_fps = 60;
+};
+
+/**
+ * @class VirtualizedList
+ * @brief A scrolling list that only ever has one widget per visible row, however many items it holds.
+ *
+ * The rows are a fixed pool of textboxes, scrolling swaps which items they show and only rows whose item changed have
+ * their text modified, so a frame costs the same for 10 or 10,000 items. Scrolling eases towards the target position
+ * instead of jumping. The list does its own hit testing of the rows, which is a division, not a search.
+ */
+class VirtualizedList {
+  public:
+    VirtualizedList(std::vector<std::string> items, std::size_t num_visible_rows)
+        : items(std::move(items)), num_visible_rows(num_visible_rows), displayed_items(num_visible_rows, no_item),
+          row_textbox_ids(num_visible_rows, -1) {}
+
+    /**
+     * @brief How quickly the scroll position catches up with the target, higher is snappier.
+     */
+    float scroll_smoothing = 18;
+
+    /**
+     * @brief Adds the row textboxes and a status line to the ui, laid out inside rect.
+     */
+    void build(UI &ui, const vertex_geometry::Rectangle &rect) {
+        std::vector<vertex_geometry::Rectangle> list_and_status = weighted_subdivision(
+            rect, {static_cast<unsigned int>(num_visible_rows), 1}, vertex_geometry::CutDirection::horizontal);
+        const vertex_geometry::Rectangle &list_rect = list_and_status.at(0);
+        list_left = list_rect.center.x - list_rect.width / 2;
+        list_right = list_rect.center.x + list_rect.width / 2;
+        list_top = list_rect.center.y + list_rect.height / 2;
+        row_height = list_rect.height / num_visible_rows;
+
+        vertex_geometry::Grid row_grid(num_visible_rows, 1, list_rect);
+        std::size_t first_row = get_first_row();
+        for (std::size_t slot = 0; slot < num_visible_rows; ++slot) {
+            displayed_items[slot] = first_row + slot;
+            displayed_highlights[slot] = first_row + slot == highlighted_item;
+            row_textbox_ids[slot] = ui.add_textbox(get_row_text(first_row + slot), row_grid.get_at(0, slot),
+                                                   colors::grey);
+        }
+        displayed_first_row = first_row;
+        displayed_status = get_status_text();
+        status_textbox_id = ui.add_textbox(displayed_status, list_and_status.at(1), colors::grey10);
+    }
+
+    std::size_t get_num_items() const { return items.size(); }
+    std::size_t get_highlighted_item() const { return highlighted_item; }
+
+    void scroll_by(float rows) { target_position = std::clamp(target_position + rows, 0.0f, get_max_position()); }
+
+    /**
+     * @brief Jumps to the item without easing and highlights it, used to show the current value when opening.
+     */
+    void scroll_to(std::size_t item) {
+        highlighted_item = std::min(item, items.empty() ? 0 : items.size() - 1);
+        float centered = static_cast<float>(highlighted_item) - static_cast<float>(num_visible_rows / 2);
+        target_position = position = std::clamp(centered, 0.0f, get_max_position());
+    }
+
+    /**
+     * @brief Moves the highlight by delta items, scrolling just enough to keep it visible.
+     */
+    void move_highlight(int delta) {
+        if (items.empty()) {
+            return;
+        }
+        long long moved = static_cast<long long>(highlighted_item) + delta;
+        highlighted_item = static_cast<std::size_t>(std::clamp<long long>(moved, 0, items.size() - 1));
+        if (highlighted_item < target_position) {
+            target_position = highlighted_item;
+        } else if (highlighted_item >= target_position + num_visible_rows) {
+            target_position = static_cast<float>(highlighted_item - num_visible_rows + 1);
+        }
+    }
+
+    /**
+     * @brief Eases the scroll position, highlights the row under the mouse and updates the rows that changed.
+     *
+     * @note the row under the mouse only takes the highlight when the mouse moves (or clicks), so a mouse resting over
+     * the list doesn't undo scroll_to and move_highlight every frame.
+     * @return the item that was clicked, if one was
+     */
+    std::optional<std::size_t> update(UI &ui, const glm::vec2 &mouse_position, bool clicked) {
+        auto now = std::chrono::steady_clock::now();
+        float delta_seconds = std::min(std::chrono::duration<float>(now - last_update_time).count(), 0.1f);
+        last_update_time = now;
+        position += (target_position - position) * (1 - std::exp(-scroll_smoothing * delta_seconds));
+        if (std::abs(target_position - position) < 0.01f) {
+            position = target_position;
+        }
+
+        bool mouse_moved = last_mouse_position.has_value() && last_mouse_position.value() != mouse_position;
+        last_mouse_position = mouse_position;
+
+        std::optional<std::size_t> clicked_item;
+        float rows_from_top = (list_top - mouse_position.y) / row_height;
+        if (mouse_position.x >= list_left && mouse_position.x <= list_right && rows_from_top >= 0 &&
+            rows_from_top < num_visible_rows) {
+            std::size_t item = get_first_row() + static_cast<std::size_t>(rows_from_top);
+            if (item < items.size() && (mouse_moved || clicked)) {
+                highlighted_item = item;
+                if (clicked) {
+                    clicked_item = item;
+                }
+            }
+        }
+
+        refresh_rows(ui);
+        return clicked_item;
+    }
+
+    /**
+     * @brief Replaces the items, the list goes back to the top and the rows are updated right away.
+     */
+    void set_items(UI &ui, std::vector<std::string> new_items) {
+        items = std::move(new_items);
+        highlighted_item = 0;
+        position = target_position = 0;
+        std::fill(displayed_items.begin(), displayed_items.end(), no_item);
+        displayed_first_row = no_item;
+        refresh_rows(ui);
+    }
+
+  private:
+    void refresh_rows(UI &ui) {
+        std::size_t first_row = get_first_row();
+        for (std::size_t slot = 0; slot < num_visible_rows; ++slot) {
+            std::size_t item = first_row + slot;
+            bool highlighted = item == highlighted_item;
+            if (displayed_items[slot] != item || displayed_highlights[slot] != highlighted) {
+                ui.modify_text_of_a_textbox(row_textbox_ids[slot], get_row_text(item));
+                displayed_items[slot] = item;
+                displayed_highlights[slot] = highlighted;
+            }
+        }
+        if (first_row != displayed_first_row) {
+            displayed_first_row = first_row;
+            displayed_status = get_status_text();
+            ui.modify_text_of_a_textbox(status_textbox_id, displayed_status);
+        }
+    }
+
+    static constexpr std::size_t no_item = std::numeric_limits<std::size_t>::max();
+
+    float get_max_position() const {
+        return items.size() > num_visible_rows ? static_cast<float>(items.size() - num_visible_rows) : 0.0f;
+    }
+
+    std::size_t get_first_row() const { return static_cast<std::size_t>(std::lround(position)); }
+
+    std::string get_row_text(std::size_t item) const {
+        if (item >= items.size()) {
+            return " ";
+        }
+        return item == highlighted_item ? "> " + items[item] : items[item];
+    }
+
+    std::string get_status_text() const {
+        if (items.empty()) {
+            return "empty";
+        }
+        std::size_t first_row = get_first_row();
+        std::size_t last_row = std::min(first_row + num_visible_rows, items.size());
+        return std::to_string(first_row + 1) + "-" + std::to_string(last_row) + " of " + std::to_string(items.size());
+    }
+
+    std::vector<std::string> items;
+    std::size_t num_visible_rows;
+
+    float position = 0, target_position = 0; // in rows, position is eased towards target_position
+    std::size_t highlighted_item = 0;
+    std::chrono::steady_clock::time_point last_update_time = std::chrono::steady_clock::now();
+    std::optional<glm::vec2> last_mouse_position;
+
+    float list_left = 0, list_right = 0, list_top = 0, row_height = 1;
+    std::vector<std::size_t> displayed_items;
+    std::vector<bool> displayed_highlights = std::vector<bool>(num_visible_rows, false);
+    std::size_t displayed_first_row = 0;
+    std::string displayed_status;
+    std::vector<int> row_textbox_ids;
+    int status_textbox_id = -1;
+};
+
+/**
+ * @class TrigramSearchIndex
+ * @brief Fuzzy search over a fixed set of short texts (eg setting labels) through an index of their trigrams.
+ *
+ * A text matches when it contains at least half of the query's trigrams, so typos and partial words still find it.
+ * Searching is incremental: the match count of every text is kept between searches and only the posting lists of the
+ * trigrams that were added to or removed from the query are walked, which is a handful per keystroke.
+ */
+class TrigramSearchIndex {
+  public:
+    /**
+     * @return the id of the text, ids are given out in order starting at 0
+     */
+    std::size_t add(const std::string &text) {
+        std::size_t id = num_texts++;
+        for (uint32_t trigram : get_trigrams(" " + text + " ")) {
+            postings[trigram].push_back(id);
+        }
+        match_counts.push_back(0);
+        return id;
+    }
+
+    /**
+     * @return the ids of the matching texts, best match first, or every id for an empty query
+     */
+    const std::vector<std::size_t> &search(const std::string &query) {
+        std::vector<uint32_t> query_trigrams = get_trigrams(" " + query);
+
+        std::vector<uint32_t> added, removed;
+        std::set_difference(query_trigrams.begin(), query_trigrams.end(), current_trigrams.begin(),
+                            current_trigrams.end(), std::back_inserter(added));
+        std::set_difference(current_trigrams.begin(), current_trigrams.end(), query_trigrams.begin(),
+                            query_trigrams.end(), std::back_inserter(removed));
+        for (uint32_t trigram : added) {
+            for (std::size_t id : get_postings(trigram)) {
+                if (match_counts[id]++ == 0) {
+                    candidates.push_back(id);
+                }
+            }
+        }
+        for (uint32_t trigram : removed) {
+            for (std::size_t id : get_postings(trigram)) {
+                match_counts[id]--;
+            }
+        }
+        current_trigrams = std::move(query_trigrams);
+
+        // pruned before the empty query return too, otherwise a text dropped to 0 there is pushed again when its
+        // count next rises and shows up twice in the results
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                        [this](std::size_t id) { return match_counts[id] == 0; }),
+                         candidates.end());
+
+        results.clear();
+        if (query.empty()) {
+            for (std::size_t id = 0; id < num_texts; ++id) {
+                results.push_back(id);
+            }
+            return results;
+        }
+
+        std::size_t min_matches = (current_trigrams.size() + 1) / 2;
+        for (std::size_t id : candidates) {
+            if (match_counts[id] >= min_matches) {
+                results.push_back(id);
+            }
+        }
+        std::sort(results.begin(), results.end(), [this](std::size_t a, std::size_t b) {
+            return match_counts[a] != match_counts[b] ? match_counts[a] > match_counts[b] : a < b;
+        });
+        return results;
+    }
+
+  private:
+    /**
+     * @brief The unique trigrams of the lowercased text, sorted, with a space in front so word starts rank higher.
+     */
+    static std::vector<uint32_t> get_trigrams(const std::string &text) {
+        std::string lowercase = " " + text;
+        std::transform(lowercase.begin(), lowercase.end(), lowercase.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        std::vector<uint32_t> trigrams;
+        for (std::size_t i = 0; i + 3 <= lowercase.size(); ++i) {
+            trigrams.push_back(static_cast<uint32_t>(static_cast<unsigned char>(lowercase[i])) << 16 |
+                               static_cast<uint32_t>(static_cast<unsigned char>(lowercase[i + 1])) << 8 |
+                               static_cast<uint32_t>(static_cast<unsigned char>(lowercase[i + 2])));
+        }
+        std::sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+        return trigrams;
+    }
+
+    const std::vector<std::size_t> &get_postings(uint32_t trigram) const {
+        static const std::vector<std::size_t> no_postings;
+        auto it = postings.find(trigram);
+        return it == postings.end() ? no_postings : it->second;
+    }
+
+    std::size_t num_texts = 0;
+    std::unordered_map<uint32_t, std::vector<std::size_t>> postings;
+
+    std::vector<uint32_t> current_trigrams;
+    std::vector<std::size_t> match_counts; // how many of current_trigrams each text contains
+    std::vector<std::size_t> candidates;   // every text with a match count above 0, each once
+    std::vector<std::size_t> results;
+};
+
+/**
+ * @brief Identifies a panel of the menu, the built in UIStates are 0 to MenuSystem<UIState>::num_states - 1 and
+ * panels registered at runtime follow them.
+ */
+using MenuPanelId = std::size_t;
+
+/**
+ * @brief What a layer of the menu covers, bounds is everywhere it may draw and opaque_rects are the parts it fully
+ * hides whatever is beneath.
+ */
+struct MenuLayerCoverage {
+    vertex_geometry::Rectangle bounds;
+    std::vector<vertex_geometry::Rectangle> opaque_rects;
+
+    /**
+     * @brief Whether the union of the given rectangles hides all of bounds, this is exact and not just a check
+     * against each rectangle on its own.
+     */
+    bool is_hidden_by(const std::vector<vertex_geometry::Rectangle> &covering_rects) const {
+        if (covering_rects.empty()) {
+            return false;
+        }
+        auto min_x = [](const vertex_geometry::Rectangle &rect) { return rect.center.x - rect.width / 2; };
+        auto max_x = [](const vertex_geometry::Rectangle &rect) { return rect.center.x + rect.width / 2; };
+        auto min_y = [](const vertex_geometry::Rectangle &rect) { return rect.center.y - rect.height / 2; };
+        auto max_y = [](const vertex_geometry::Rectangle &rect) { return rect.center.y + rect.height / 2; };
+
+        // split bounds along every covering edge, then each cell is either fully covered or not covered at all
+        std::vector<float> xs = {min_x(bounds), max_x(bounds)}, ys = {min_y(bounds), max_y(bounds)};
+        for (const auto &rect : covering_rects) {
+            for (float x : {min_x(rect), max_x(rect)}) {
+                if (x > xs[0] && x < xs[1]) {
+                    xs.push_back(x);
+                }
+            }
+            for (float y : {min_y(rect), max_y(rect)}) {
+                if (y > ys[0] && y < ys[1]) {
+                    ys.push_back(y);
+                }
+            }
+        }
+        std::sort(xs.begin(), xs.end());
+        std::sort(ys.begin(), ys.end());
+
+        for (std::size_t i = 0; i + 1 < xs.size(); ++i) {
+            for (std::size_t j = 0; j + 1 < ys.size(); ++j) {
+                float cell_x = (xs[i] + xs[i + 1]) / 2, cell_y = (ys[j] + ys[j + 1]) / 2;
+                bool cell_covered = std::any_of(covering_rects.begin(), covering_rects.end(), [&](const auto &rect) {
+                    return cell_x >= min_x(rect) && cell_x <= max_x(rect) && cell_y >= min_y(rect) &&
+                           cell_y <= max_y(rect);
+                });
+                if (!cell_covered) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * @class SpatialNavigationGraph
+ * @brief The interactive widgets of a menu linked to their nearest neighbour in each direction, so arrow keys and a
+ * gamepad's d-pad can move focus between them.
+ *
+ * The links are computed by build() whenever the layout changes, moving focus afterwards is a single lookup.
+ */
+class SpatialNavigationGraph {
+  public:
+    enum class Direction { up, down, left, right };
+    static constexpr std::size_t no_widget = std::numeric_limits<std::size_t>::max();
+
+    /**
+     * @brief Links every widget to the closest widget in each direction.
+     *
+     * @note a widget that overlaps the current one sideways (eg the next widget in the same column) is preferred over
+     * one that is closer but diagonal to it, widgets more than 45 degrees off the direction are never picked.
+     */
+    void build(std::vector<vertex_geometry::Rectangle> widget_rects) {
+        rects = std::move(widget_rects);
+        neighbors.assign(rects.size(), {no_widget, no_widget, no_widget, no_widget});
+        for (std::size_t from = 0; from < rects.size(); ++from) {
+            for (std::size_t direction = 0; direction < 4; ++direction) {
+                float best_score = std::numeric_limits<float>::max();
+                for (std::size_t to = 0; to < rects.size(); ++to) {
+                    std::optional<float> score = get_score(rects[from], rects[to], static_cast<Direction>(direction));
+                    if (to != from && score.has_value() && score.value() < best_score) {
+                        best_score = score.value();
+                        neighbors[from][direction] = to;
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @return the widget focus moves to, or no_widget if there is nothing in that direction
+     */
+    std::size_t get_neighbor(std::size_t widget, Direction direction) const {
+        return neighbors[widget][static_cast<std::size_t>(direction)];
+    }
+
+    const vertex_geometry::Rectangle &get_rect(std::size_t widget) const { return rects[widget]; }
+    bool empty() const { return rects.empty(); }
+
+  private:
+    /**
+     * @return how far the move from one widget to another is, lower is better, or std::nullopt if to isn't in that
+     * direction at all
+     */
+    static std::optional<float> get_score(const vertex_geometry::Rectangle &from, const vertex_geometry::Rectangle &to,
+                                          Direction direction) {
+        bool vertical = direction == Direction::up || direction == Direction::down;
+        float sign = direction == Direction::up || direction == Direction::right ? 1 : -1;
+        float along = sign * (vertical ? to.center.y - from.center.y : to.center.x - from.center.x);
+        if (along <= 0) {
+            return std::nullopt;
+        }
+        float across = std::abs(vertical ? to.center.x - from.center.x : to.center.y - from.center.y);
+        float overlap_distance = vertical ? (from.width + to.width) / 2 : (from.height + to.height) / 2;
+        if (across < overlap_distance) {
+            return along;
+        }
+        // widgets that don't overlap sideways have to be within 45 degrees of the direction
+        return across < along ? std::optional<float>(along + 2 * across) : std::nullopt;
+    }
+
+    std::vector<vertex_geometry::Rectangle> rects;
+    std::vector<std::array<std::size_t, 4>> neighbors; // indexed by widget then Direction
+};
+
+/**
+ * @class InputGraphicsSoundMenu
+ * @brief Handles all user interface (UI) states related to input, graphics, and sound configuration.
+ *
+ * This class manages multiple UI panels including main menu, settings menus, and submenus for
+ * sound, graphics, input, and player settings. It integrates input, configuration, sound, and rendering systems
+ * to create an interactive settings menu for the engine or game.
+ *
+ * @note which uis are drawn for each state and which state changes are allowed are described by
+ * MenuStateTable<UIState> and resolved at compile time by MenuSystem, a different menu can reuse it with its own enum.
+ */
+class InputGraphicsSoundMenu {
+  private:
+    vertex_geometry::Rectangle settings_menu_rect = vertex_geometry::Rectangle(glm::vec3(0, 0, 0), 1.2, 1.2);
+    std::vector<vertex_geometry::Rectangle> settings_menu =
+        weighted_subdivision(settings_menu_rect, {1, 3}, vertex_geometry::CutDirection::horizontal);
+
+    SoundSystem &sound_system;
+    Batcher &batcher;
+    Configuration &configuration;
+    Window &window;
+    InputState &input_state; // used to resolve key strings and to capture key presses when binding
+
+    Logger logger = Logger("input_graphics_sound_menu");
+
+    std::unique_ptr<SettingsJournal> settings_journal;
+
+    std::unordered_map<std::string, std::vector<std::function<void(const std::string)>>> config_handlers;
+    std::unique_ptr<ConfigFileWatcher> config_file_watcher;
+    std::deque<ConfigReloadTiming> config_reload_timings;
+
+    SettingsProfiles settings_profiles;
+    // picked in the settings menu, switched to at the start of the next frame so no ui is rebuilt while processing
+    std::optional<std::string> pending_settings_profile;
+    // set by the quality_preset handler and applied at the start of the next frame, outside of any apply pass, since
+    // applying one may run the benchmark and sets the resolution
+    std::optional<std::string> pending_quality_preset;
+
+    SettingsHistory settings_history;
+    // like profile switches, undo and redo clicked in the settings menu are applied at the start of the next frame
+    bool undo_requested = false, redo_requested = false;
+
+    NullAudioBackend null_audio_backend;
+    IAudioBackend &audio_backend;
+    ResidentSoundPool resident_ui_sounds;
+    AudioDeviceCache audio_device_cache;
+    AudioOutputConfig audio_output_config;
+    bool audio_output_config_dirty = false;
+    bool sound_settings_ui_stale = false;
+
+    struct InputBindingSetting {
+        InputAction action;
+        std::string label;
+        std::string config_key;
+        std::string default_key;
+    };
+
+    const std::vector<InputBindingSetting> input_binding_settings = {
+        {InputAction::FIRE, "fire", "fire", "left_mouse_button"},
+        {InputAction::JUMP, "jump", "jump", "space"},
+        {InputAction::MOVE_FORWARD, "move forward", "forward", "w"},
+        {InputAction::MOVE_BACKWARD, "move backward", "back", "s"},
+        {InputAction::MOVE_LEFT, "move left", "left", "a"},
+        {InputAction::MOVE_RIGHT, "move right", "right", "d"},
+        {InputAction::MOVE_UP, "move up", "up", "e"},
+        {InputAction::MOVE_DOWN, "move down", "down", "left_shift"},
+        {InputAction::SLOW_MOVE, "slow move", "slow_move", "left_control"},
+        {InputAction::FAST_MOVE, "fast move", "fast_move", "tab"},
+    };
+
+    // these are only treated as modifiers while capturing, pressing one on its own still binds it
+    const std::vector<std::string> modifier_key_strings = {"left_shift", "right_shift", "left_control",
+                                                           "right_control", "left_alt",  "right_alt"};
+
+    const std::vector<std::string> mouse_sensitivity_config_keys = {
+        "mouse_sensitivity", "mouse_curve", "mouse_curve_exponent", "mouse_curve_points", "mouse_x_scale",
+        "mouse_y_scale"};
+
+    // sorted from fewest to most pixels, filled in when the graphics settings are created
+    std::vector<std::string> resolution_options;
+
+    static constexpr float min_field_of_view_degrees = 30, max_field_of_view_degrees = 160;
+    float field_of_view_degrees = 90;
+
+    /**
+     * @brief A slider over a config value, its track is dragged with the mouse, while dragging the value is previewed
+     * by running the key's handlers and it is only written to the config on release.
+     */
+    struct MenuSlider {
+        std::string section, key;
+        float min_value, max_value;
+        vertex_geometry::Rectangle track;
+        int value_textbox_id;
+        std::function<float()> get_value; // the applied value, which the key's handlers keep up to date
+        std::function<std::string(float)> format_value;
+        bool dragging = false;
+        std::optional<float> shown_value; // the value the handle and the textbox show
+        // the handle moves with the value and the ui can't move a rectangle, so it is a tiny ui of its own drawn over
+        // the slider's panel which is rebuilt whenever the value changes
+        std::unique_ptr<UI> handle_ui;
+        MenuLayerCoverage handle_coverage;
+    };
+    // the sliders of each built in ui, refilled whenever the ui is rebuilt
+    std::array<std::vector<MenuSlider>, MenuSystem<UIState>::num_states> sliders;
+
+    // the working copy of what is published through game_settings_publisher
+    GameSettings game_settings;
+
+    DynamicResolutionController dynamic_resolution_controller;
+    bool adaptive_render_scale = false;
+    float fixed_render_scale = 1.0f;
+
+    int render_scale_textbox_id = -1, render_scale_state_textbox_id = -1;
+    std::string displayed_render_scale, displayed_render_scale_state;
+
+    std::array<std::vector<KeyChord>, InputBindingTable::num_actions> bound_chords;
+    std::array<int, InputBindingTable::num_actions> binding_textbox_ids = {};
+    std::optional<InputAction> capturing_action;
+    bool capture_adds_binding = false;
+    std::optional<EKey> captured_modifier;
+
+    int underrun_textbox_id = -1, output_latency_textbox_id = -1;
+    unsigned int displayed_underrun_count = 0;
+    double displayed_output_latency_ms = -1;
+
+    const std::vector<std::pair<SoundBus, std::string>> sound_bus_config_keys = {
+        {SoundBus::MASTER, "master_volume"},
+        {SoundBus::UI, "ui_volume"},
+        {SoundBus::MUSIC, "music_volume"},
+        {SoundBus::EFFECTS, "effects_volume"},
+    };
+
+    /**
+     * @brief The ui sounds preloaded when the host doesn't pass its own.
+     */
+    inline static const std::unordered_map<SoundType, std::string> default_resident_ui_sound_files = {
+        {SoundType::HOVER, "assets/sounds/hover.wav"},
+        {SoundType::CLICK, "assets/sounds/click.wav"},
+    };
+
+    /**
+     * @brief Plays a ui sound unless the ui bus (or master) has been muted in the sound settings.
+     *
+     * @note resident ui sounds go straight to the backend's short latency voice, anything else (or a backend without
+     * one) goes through the SoundSystem queue.
+     */
+    void play_ui_sound(SoundType sound_type) {
+        auto requested_at = std::chrono::steady_clock::now();
+        float gain = sound_bus_mixer.get_effective_gain(SoundBus::UI);
+        if (gain <= 0) {
+            return;
+        }
+
+        const ResidentSound *resident_sound = resident_ui_sounds.get(sound_type);
+        if (resident_sound != nullptr && audio_backend.play_resident(*resident_sound, gain, requested_at)) {
+            return;
+        }
+        sound_system.queue_sound(sound_type);
+    }
+
+    /**
+     * @brief A dialog drawn over the current state's uis, while one is open nothing beneath it gets input.
+     */
+    struct MenuModal {
+        UI ui;
+        MenuLayerCoverage coverage;
+        // set for list popups, the list is updated and its pick handled by the frame loop
+        std::unique_ptr<VirtualizedList> list;
+        std::function<void(std::size_t)> on_list_pick;
+        bool is_settings_search = false;
+        SpatialNavigationGraph navigation_graph; // empty for modals that aren't navigated by focus
+    };
+    std::vector<std::unique_ptr<MenuModal>> modal_stack;
+    // a modal closed from one of its own controls is removed at the start of the next frame, not while it's processed
+    std::size_t num_modal_closes_requested = 0;
+    float pending_list_scroll_rows = 0;
+
+    struct SettingsSearchTarget {
+        UIState ui_state;
+        std::string label;
+        int textbox_id; // updated whenever the ui is rebuilt
+    };
+    // one entry per setting label, added the first time its ui is built, the index of a target is its id in the index
+    TrigramSearchIndex settings_search_index;
+    std::vector<SettingsSearchTarget> settings_search_targets;
+    std::map<std::pair<UIState, std::string>, std::size_t> settings_search_target_ids;
+    std::vector<std::size_t> settings_search_results;
+    std::string settings_search_query;
+    int settings_search_query_textbox_id = -1;
+    std::optional<std::size_t> highlighted_search_target;
+
+    enum class TextWrap { none, long_lines };
+    struct LocalizedTextbox {
+        int textbox_id;
+        TextId text; // its source points into source_texts
+        TextWrap wrap;
+    };
+    std::optional<LocalizationTable> localization_table; // no table shows the source text
+    // the textboxes of each built in panel that show localized text, refilled whenever the panel is rebuilt
+    std::array<std::vector<LocalizedTextbox>, MenuSystem<UIState>::num_states> localized_textboxes;
+    std::unordered_map<uint64_t, std::string> source_texts; // interned, one copy however many textboxes show it
+    // the uis with buttons, tabs or other text localized when they're built, the ui has no way to change that text in
+    // place so these are rebuilt at the start of the frame after the language changes
+    static constexpr std::array<UIState, 6> uis_with_built_in_text = {
+        UIState::MAIN_MENU,      UIState::SETTINGS_MENU,  UIState::INPUT_SETTINGS,
+        UIState::SOUND_SETTINGS, UIState::MOUSE_SETTINGS, UIState::ABOUT};
+    bool built_in_text_stale = false;
+
+    struct FocusTarget {
+        vertex_geometry::Rectangle rect;
+        // set for dropdowns, whose options can't be focused, confirming one opens its options in a list popup instead
+        std::function<void()> open_as_list;
+    };
+    // the interactive widgets of each built in ui, refilled whenever the ui is rebuilt
+    std::array<std::vector<FocusTarget>, MenuSystem<UIState>::num_states> focus_targets;
+    // per state, the focus targets of every ui drawn for it
+    std::array<SpatialNavigationGraph, MenuSystem<UIState>::num_states> navigation_graphs;
+    // per state, the open_as_list of each widget in its navigation graph
+    std::array<std::vector<std::function<void()>>, MenuSystem<UIState>::num_states> navigation_list_openers;
+    const SpatialNavigationGraph *focused_graph = nullptr;
+    std::size_t focused_widget = SpatialNavigationGraph::no_widget;
+    glm::vec2 last_mouse_position = glm::vec2(0, 0);
+    std::array<bool, 4> gamepad_dpad_was_pressed = {};
+    bool gamepad_confirm_was_pressed = false;
+    std::optional<EKey> up_key, down_key, left_key, right_key;
+
+    /**
+     * @brief A settings panel registered at runtime by another module, it is drawn over an existing panel and gets a
+     * tab in the settings menu when that panel is the settings menu.
+     */
+    struct RegisteredPanel {
+        std::string tab_label;
+        std::function<void(UI &, const vertex_geometry::Rectangle &)> build_ui;
+        MenuPanelId drawn_over;
+        UIState drawn_over_state; // the built in state it is drawn over, directly or through other registered panels
+        UI ui;
+    };
+    std::vector<std::unique_ptr<RegisteredPanel>> registered_panels; // the panel with id num_states + i is at i
+    // set while a registered panel is open, curr_state then holds the built in state it was opened over
+    std::optional<MenuPanelId> curr_registered_panel;
+
+    // everything the frame loop needs about a panel, indexed by MenuPanelId, the built in states come first
+    std::vector<UI *> panel_uis;
+    std::vector<MenuLayerCoverage> panel_coverages;
+    std::vector<std::vector<MenuPanelId>> panel_render_orders;
+
+    // the panels to return to on BACK, the most recent last
+    std::vector<MenuPanelId> navigation_stack;
+    struct FrameLayer {
+        UI *ui;
+        const MenuLayerCoverage *coverage;
+        bool visible;
+    };
+    // reused every frame so building the layer list doesn't allocate
+    std::vector<FrameLayer> frame_layers;
+    std::vector<vertex_geometry::Rectangle> frame_opaque_rects;
+
+    std::function<void()> on_hover = [&]() { play_ui_sound(SoundType::HOVER); };
+    std::function<void(const std::string)> dropdown_on_hover = [&](const std::string) {
+        play_ui_sound(SoundType::HOVER);
+    };
+
+  public:
+    /**
+     * @brief Holds the per-bus gains driven by the sound settings, run this from the audio callback to apply them.
+     */
+    SoundBusMixer sound_bus_mixer;
+
+    /**
+     * @brief The compiled key bindings from the input settings, query this from gameplay code.
+     */
+    InputBindingTable input_binding_table;
+
+    /**
+     * @brief The compiled mouse sensitivity settings, run every raw mouse delta through this.
+     */
+    MouseSensitivityCurve mouse_sensitivity_curve;
+
+    /**
+     * @brief Paces frame submission when the low latency setting is on, see FramePacer for where to call it.
+     */
+    FramePacer frame_pacer;
+
+    /**
+     * @brief Applies resolution and fullscreen changes in a single mode switch, its timings report how long each
+     * switch took.
+     */
+    WindowModeTransaction window_mode_transaction;
+
+    /**
+     * @brief A new version of the game settings is published here every time one of them changes, read it from any
+     * thread without locking or looking strings up.
+     */
+    SettingsSnapshotPublisher<GameSettings> game_settings_publisher;
+
+    /**
+     * @brief Called with the field of view in degrees whenever it changes, including every frame while the slider is
+     * dragged, so only update the projection matrix in here. The config is only written once the slider is released.
+     */
+    std::function<void(float)> on_field_of_view_change = [](float) {};
+
+    bool enabled = true;
+    UIState curr_state = UIState::MAIN_MENU;
+
+    UI main_menu_ui, about_ui, settings_menu_ui, player_settings_ui, input_settings_ui, sound_settings_ui,
+        graphics_settings_ui, advanced_settings_ui, mouse_settings_ui;
+
+    /**
+     * @brief The ui member of each state, a switch so that a state added to the enum without a ui is a -Wswitch
+     * warning instead of a silently shifted table.
+     */
+    UI &get_state_ui(UIState ui_state) {
+        switch (ui_state) {
+        case UIState::MAIN_MENU:
+            return main_menu_ui;
+        case UIState::SETTINGS_MENU:
+            return settings_menu_ui;
+        case UIState::PROGRAM_SETTINGS:
+            return player_settings_ui;
+        case UIState::INPUT_SETTINGS:
+            return input_settings_ui;
+        case UIState::SOUND_SETTINGS:
+            return sound_settings_ui;
+        case UIState::GRAPHICS_SETTINGS:
+            return graphics_settings_ui;
+        case UIState::ADVANCED_SETTINGS:
+            return advanced_settings_ui;
+        case UIState::MOUSE_SETTINGS:
+            return mouse_settings_ui;
+        case UIState::ABOUT:
+            return about_ui;
+        }
+        return main_menu_ui;
+    }
+
+    std::array<UI *, MenuSystem<UIState>::num_states> create_state_to_ui() {
+        std::array<UI *, MenuSystem<UIState>::num_states> uis{};
+        for (std::size_t i = 0; i < uis.size(); ++i) {
+            uis[i] = &get_state_ui(static_cast<UIState>(i));
+        }
+        return uis;
+    }
+
+    // indexed by UIState, built from the enum so it can't fall out of step with it
+    std::array<UI *, MenuSystem<UIState>::num_states> state_to_ui = create_state_to_ui();
+
+    /**
+     * @brief Constructs an InputGraphicsSoundMenu and initializes all UIs and configuration handlers.
+     *
+     * @param window Reference to the main Window.
+     * @param input_state Reference to the InputState used for handling input bindings.
+     * @param batcher Reference to the Batcher used for UI rendering.
+     * @param sound_system Reference to the SoundSystem for playing UI sounds.
+     * @param configuration Reference to the Configuration object managing persistent settings.
+     *
+     * @note This constructor also registers configuration handlers for graphics-related settings
+     *       (resolution, fullscreen, wireframe) and applies configuration logic upon initialization. Resolution and
+     *       fullscreen changes are staged in window_mode_transaction and committed together.
+     * @throws std::invalid_argument If a configuration handler attempts to parse an invalid setting string.
+     */
+    InputGraphicsSoundMenu(Window &window, InputState &input_state, Batcher &batcher, SoundSystem &sound_system,
+                           Configuration &configuration)
+        : InputGraphicsSoundMenu(window, input_state, batcher, sound_system, configuration, null_audio_backend) {}
+
+    /**
+     * @brief Constructs an InputGraphicsSoundMenu whose sound settings control the given audio output.
+     *
+     * @param audio_backend The backend used to list output devices and to apply device, sample rate and buffer size
+     * changes, it must outlive the menu.
+     * @param resident_ui_sound_files wav files for the ui sounds (HOVER, CLICK, ...), these are decoded up front and
+     * played through the backend's short latency voice instead of the SoundSystem queue, when empty
+     * default_resident_ui_sound_files are used.
+     * @param config_file_path the ini the configuration was loaded from.
+     *
+     * @note when config_file_path is given, changes made through the menu are journaled next to it (config_file_path +
+     * ".journal") as they happen and the journal is replayed here, so nothing is lost if the game dies before SAVE.
+     */
+    InputGraphicsSoundMenu(Window &window, InputState &input_state, Batcher &batcher, SoundSystem &sound_system,
+                           Configuration &configuration, IAudioBackend &audio_backend,
+                           const std::unordered_map<SoundType, std::string> &resident_ui_sound_files = {},
+                           const std::string &config_file_path = "")
+        : window(window), input_state(input_state), batcher(batcher), sound_system(sound_system),
+          configuration(configuration), settings_journal(open_settings_journal(config_file_path)),
+          audio_backend(audio_backend), audio_device_cache(audio_backend),
+          window_mode_transaction(window, get_config_value("graphics", "resolution").value_or(""),
+                                  get_config_value("graphics", "fullscreen").value_or("")),
+          main_menu_ui(create_main_menu_ui()), about_ui(create_about_ui()),
+          settings_menu_ui(create_settings_menu_ui()), player_settings_ui(create_player_settings_ui()),
+          input_settings_ui(create_input_settings_ui()), sound_settings_ui(create_sound_settings_ui()),
+          graphics_settings_ui(create_graphics_settings_ui()), advanced_settings_ui(create_advanced_settings_ui()),
+          mouse_settings_ui(create_mouse_settings_ui()) {
+
+        up_key = key_string_to_key("up");
+        down_key = key_string_to_key("down");
+        left_key = key_string_to_key("left");
+        right_key = key_string_to_key("right");
+        for (std::size_t i = 0; i < Menu::num_states; ++i) {
+            build_navigation_graph(static_cast<UIState>(i));
+        }
+
+        for (std::size_t i = 0; i < Menu::num_states; ++i) {
+            const auto &render_order = Menu::get_render_order(static_cast<UIState>(i));
+            panel_uis.push_back(state_to_ui[i]);
+            panel_coverages.push_back(get_state_layer_coverage(static_cast<UIState>(i)));
+            panel_render_orders.emplace_back();
+            for (UIState ui_state : render_order) {
+                panel_render_orders.back().push_back(Menu::index(ui_state));
+            }
+        }
+
+        for (const auto &sound_type : resident_ui_sounds.load(
+                 resident_ui_sound_files.empty() ? default_resident_ui_sound_files : resident_ui_sound_files)) {
+            logger.warn("couldn't preload ui sound {}, it will be played through the sound system instead",
+                        static_cast<int>(sound_type));
+        }
+
+        register_config_handler("graphics", "resolution", [&](const std::string resolution) {
+            window_mode_transaction.stage_resolution(resolution);
+        });
+
+        register_config_handler("graphics", "fullscreen", [&](const std::string value) {
+            window_mode_transaction.stage_fullscreen(value);
+        });
+
+        register_config_handler("graphics", "wireframe", [&](const std::string value) {
+            if (value == "on") {
+                window.enable_wireframe_mode();
+            } else if (value == "off") {
+                window.disable_wireframe_mode();
+            }
+        });
+
+        for (const auto &[bus, key] : sound_bus_config_keys) {
+            register_config_handler("sound", key, [this, bus = bus](const std::string value) {
+                sound_bus_mixer.set_bus_gain(bus, parse_percentage(value));
+                // the master gain scales every bus, so all of them are pushed when it changes
+                for (const auto &[other_bus, other_key] : sound_bus_config_keys) {
+                    this->audio_backend.set_bus_gain(other_bus, sound_bus_mixer.get_effective_gain(other_bus));
+                }
+                game_settings.bus_gains[static_cast<std::size_t>(bus)] = sound_bus_mixer.get_bus_gain(bus);
+                game_settings_publisher.publish(game_settings);
+            });
+        }
+
+        register_config_handler("sound", "output_device", [this](const std::string value) {
+            audio_output_config.device_name = value;
+            audio_output_config_dirty = true;
+        });
+
+        register_config_handler("sound", "sample_rate", [this](const std::string value) {
+            audio_output_config.sample_rate = parse_positive_or_default(value, audio_output_config.sample_rate);
+            audio_output_config_dirty = true;
+        });
+
+        register_config_handler("sound", "buffer_frames", [this](const std::string value) {
+            audio_output_config.buffer_frames = parse_positive_or_default(value, audio_output_config.buffer_frames);
+            audio_output_config_dirty = true;
+        });
+
+        for (const auto &binding : input_binding_settings) {
+            InputAction action = binding.action;
+            std::function<void(const std::string)> binding_handler = [this, action](const std::string value) {
+                bind_chords(action, parse_key_chords(value));
+            };
+            register_config_handler("input", binding.config_key, binding_handler);
+        }
+
+        for (const auto &key : mouse_sensitivity_config_keys) {
+            register_config_handler("input", key, [this](const std::string) { compile_mouse_sensitivity_curve(); });
+        }
+
+        // apply_config_logic only runs the handlers of keys in the config, the actions missing from it get their
+        // default keys here
+        for (const auto &binding : input_binding_settings) {
+            if (!get_config_value("input", binding.config_key).has_value()) {
+                bound_chords[static_cast<std::size_t>(binding.action)] = parse_key_chords(binding.default_key);
+            }
+        }
+        input_binding_table.compile(bound_chords);
+
+        register_config_handler("graphics", "quality_preset",
+                                [this](const std::string value) { pending_quality_preset = value; });
+
+        register_config_handler("graphics", "render_scale", [this](const std::string value) {
+            adaptive_render_scale = value == "adaptive";
+            if (!adaptive_render_scale) {
+                fixed_render_scale = parse_percentage(value);
+            }
+            dynamic_resolution_controller.reset(fixed_render_scale);
+            update_frame_time_targets();
+        });
+
+        register_config_handler("graphics", "vsync", [this](const std::string value) { apply_vsync(value); });
+
+        register_config_handler("graphics", "max_fps", [this](const std::string) { update_frame_time_targets(); });
+
+        register_config_handler("graphics", "low_latency", [this](const std::string value) {
+            frame_pacer.configure(value == "on", 1);
+            update_frame_time_targets();
+        });
+
+        register_config_handler("graphics", "field_of_view", [this](const std::string value) {
+            set_field_of_view(parse_float_or_default(value, field_of_view_degrees));
+        });
+
+        configuration.apply_config_logic();
+        game_settings_publisher.publish(game_settings);
+        // the startup mode shouldn't wait for the debounce interval
+        window_mode_transaction.commit();
+        apply_audio_output_config_if_dirty();
+
+        logger.info("successfully initialized");
+    };
+
+    /**
+     * @brief Reports how long the last frame took, call this once per frame.
+     *
+     * @return the scale to render the next frame at relative to the window resolution, this only changes over time
+     * when the render scale setting is "adaptive".
+     */
+    float report_frame_time(double frame_time_seconds) {
+        if (!adaptive_render_scale) {
+            return fixed_render_scale;
+        }
+        return dynamic_resolution_controller.update(frame_time_seconds);
+    }
+
+    float get_field_of_view() const { return field_of_view_degrees; }
+
+    float get_render_scale() const {
+        return adaptive_render_scale ? dynamic_resolution_controller.get_scale() : fixed_render_scale;
+    }
+
+    /**
+     * @brief Starts watching the config file, whenever it changes on disk only the changed values are applied and the
+     * settings uis are updated to show them.
+     */
+    void watch_config_file(const std::string &config_file_path) {
+        config_file_watcher = std::make_unique<ConfigFileWatcher>(config_file_path, get_config_keys());
+    }
+
+    /**
+     * @brief The parse and apply times of the most recent config reloads, oldest first.
+     */
+    const std::deque<ConfigReloadTiming> &get_config_reload_timings() const { return config_reload_timings; }
+
+    /**
+     * @brief Adds a named profile whose values are those in the ini at ini_path, it can then be picked in the settings
+     * menu or switched to with switch_settings_profile.
+     *
+     * @return false if the ini couldn't be read or the name is "default", which the menu uses for the base config
+     */
+    bool load_settings_profile(const std::string &name, const std::string &ini_path) {
+        if (!settings_profiles.load_profile(name, ini_path, get_config_keys())) {
+            return false;
+        }
+        rebuild_ui(UIState::SETTINGS_MENU);
+        return true;
+    }
+
+    /**
+     * @brief Switches to the named profile, "" being the base config, only the values that differ between the two are
+     * set and only their handlers run.
+     *
+     * @return the number of values that changed
+     */
+    std::size_t switch_settings_profile(const std::string &name) {
+        auto start = std::chrono::steady_clock::now();
+        std::string previous_profile = settings_profiles.get_active_profile();
+        ConfigChanges changes = settings_profiles.switch_to(
+            name, [this](const std::string &section, const std::string &key) {
+                return configuration.get_value(section, key);
+            });
+        apply_changed_config_values(resolve_removed_values(changes));
+        double switch_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        logger.info("switched settings profile from '{}' to '{}', {} values changed in {:.2f}ms", previous_profile,
+                    settings_profiles.get_active_profile(), changes.size(), switch_ms);
+        return changes.size();
+    }
+
+    const std::string &get_settings_profile() const { return settings_profiles.get_active_profile(); }
+
+    /**
+     * @brief Adds a panel to the menu without touching this class, eg network or accessibility settings.
+     *
+     * @param tab_label the label of its tab in the settings menu, tabs are only added for panels drawn over the
+     * settings menu
+     * @param build_ui adds the panel's widgets to the ui it is given, laid out inside the given rectangle, it is called
+     * again whenever the panel is rebuilt
+     * @param drawn_over the panel drawn behind this one, another registered panel can be used to nest panels
+     * @return the panel's id, ids are dense so the frame loop looks everything about a panel up by indexing
+     *
+     * @note don't call this from a ui callback, the settings menu is rebuilt to show the new tab
+     */
+    MenuPanelId register_panel(const std::string &tab_label,
+                               std::function<void(UI &, const vertex_geometry::Rectangle &)> build_ui,
+                               MenuPanelId drawn_over = Menu::index(UIState::SETTINGS_MENU)) {
+        MenuPanelId id = panel_uis.size();
+        vertex_geometry::Rectangle panel_rect = settings_menu.at(1);
+        UI ui(-0.1, batcher.absolute_position_with_colored_vertex_shader_batcher.object_id_generator);
+        build_ui(ui, panel_rect);
+
+        // drawn_over was registered earlier, so its render order is final and no cycle can be formed
+        std::vector<MenuPanelId> render_order = panel_render_orders.at(drawn_over);
+        render_order.push_back(id);
+        UIState drawn_over_state = drawn_over < Menu::num_states
+                                       ? static_cast<UIState>(drawn_over)
+                                       : registered_panels[drawn_over - Menu::num_states]->drawn_over_state;
+        registered_panels.push_back(std::make_unique<RegisteredPanel>(
+            RegisteredPanel{tab_label, std::move(build_ui), drawn_over, drawn_over_state, std::move(ui)}));
+        panel_uis.push_back(&registered_panels.back()->ui);
+        panel_coverages.push_back({panel_rect, {}});
+        panel_render_orders.push_back(std::move(render_order));
+
+        if (drawn_over == Menu::index(UIState::SETTINGS_MENU)) {
+            rebuild_ui(UIState::SETTINGS_MENU);
+        }
+        return id;
+    }
+
+    /**
+     * @brief Opens a registered panel as if it was picked from the panel it is drawn over, BACK then leaves it.
+     */
+    void open_panel(MenuPanelId panel) {
+        navigate(registered_panels.at(panel - Menu::num_states)->drawn_over, panel);
+    }
+
+    /**
+     * @brief Shows the menu in the language of the given strings file.
+     *
+     * @param strings_path the translations, one "source<tab>translation" per line.
+     * @param table_path where the compiled table is kept, it is rebuilt whenever the strings file changes.
+     * @return false if the table couldn't be loaded or built, the current language is kept then.
+     *
+     * @note textboxes switch right away, the uis in uis_with_built_in_text (buttons and tabs) are rebuilt at the start
+     * of the next frame.
+     */
+    bool set_language(const std::string &strings_path, const std::string &table_path) {
+        std::optional<LocalizationTable> table = LocalizationTable::load_or_build(strings_path, table_path);
+        if (!table.has_value()) {
+            return false;
+        }
+        localization_table = std::move(table);
+        relayout_localized_text();
+        built_in_text_stale = true;
+        return true;
+    }
+
+    /**
+     * @brief Goes back to showing the source text.
+     */
+    void reset_language() {
+        localization_table.reset();
+        relayout_localized_text();
+        built_in_text_stale = true;
+    }
+
+    /**
+     * @brief Forward mouse wheel offsets here (eg from a glfw scroll callback) to scroll the list popup that is open.
+     */
+    void scroll_menu(double y_offset) { pending_list_scroll_rows -= static_cast<float>(y_offset) * 3; }
+
+    /**
+     * @brief Rebuilds a registered panel with its build_ui, eg after the values it shows changed.
+     */
+    void rebuild_panel(MenuPanelId panel) {
+        RegisteredPanel &registered_panel = *registered_panels.at(panel - Menu::num_states);
+        UI ui(-0.1, batcher.absolute_position_with_colored_vertex_shader_batcher.object_id_generator);
+        registered_panel.build_ui(ui, settings_menu.at(1));
+        // assigned into the existing ui, so panel_uis keeps pointing at it
+        registered_panel.ui = std::move(ui);
+    }
+
+    /**
+     * @brief Opens a yes/no dialog over the menu, nothing beneath it gets input until one of them is clicked.
+     *
+     * @param on_confirm called when yes is clicked, the dialog is closed either way
+     */
+    void push_confirmation_dialog(const std::string &message, std::function<void()> on_confirm) {
+        vertex_geometry::Rectangle dialog_rect(glm::vec3(0, 0, 0), 1, 0.5);
+        std::vector<vertex_geometry::Rectangle> dialog_rows =
+            weighted_subdivision(dialog_rect, {1, 1}, vertex_geometry::CutDirection::horizontal);
+        vertex_geometry::Grid button_grid(1, 2, dialog_rows.at(1));
+
+        std::function<void()> on_yes_clicked = [this, on_confirm]() {
+            play_ui_sound(SoundType::CLICK);
+            num_modal_closes_requested++;
+            on_confirm();
+        };
+        std::function<void()> on_no_clicked = [this]() {
+            play_ui_sound(SoundType::CLICK);
+            num_modal_closes_requested++;
+        };
+
+        UI dialog_ui(-0.2, batcher.absolute_position_with_colored_vertex_shader_batcher.object_id_generator);
+        dialog_ui.add_colored_rectangle(dialog_rect, colors::grey18);
+        dialog_ui.add_textbox(message, dialog_rows.at(0), colors::grey);
+        dialog_ui.add_clickable_textbox(on_yes_clicked, on_hover, localize("yes"), button_grid.get_at(0, 0),
+                                        colors::darkred, colors::red);
+        dialog_ui.add_clickable_textbox(on_no_clicked, on_hover, localize("no"), button_grid.get_at(1, 0),
+                                        colors::darkblue, colors::blue);
+        push_modal(std::move(dialog_ui), {dialog_rect, {dialog_rect}});
+        modal_stack.back()->navigation_graph.build({button_grid.get_at(0, 0), button_grid.get_at(1, 0)});
+    }
+
+    /**
+     * @brief Undoes the last settings edit made through the menu, values set together by one click are undone together
+     * and only the handlers of the values it touched run.
+     *
+     * @return false if there was nothing to undo
+     */
+    bool undo_settings_change() {
+        settings_history.commit_step();
+        if (!settings_history.can_undo()) {
+            return false;
+        }
+        apply_settings_history_step(settings_history.undo());
+        return true;
+    }
+
+    /**
+     * @brief Redoes the last undone settings edit.
+     *
+     * @return false if there was nothing to redo
+     */
+    bool redo_settings_change() {
+        if (!settings_history.can_redo()) {
+            return false;
+        }
+        apply_settings_history_step(settings_history.redo());
+        return true;
+    }
+
+    /**
+     * @brief The time from the last resident ui sound being requested until its first sample was output.
+     *
+     * @return the latency in milliseconds, or a negative value if the backend hasn't measured one yet.
+     */
+    double get_ui_sound_latency_ms() const { return audio_backend.get_resident_playback_latency_ms(); }
+
+  private:
+    static std::string get_config_handler_key(const std::string &section, const std::string &key) {
+        return section + "." + key;
+    }
+
+    /**
+     * @brief Registers a handler with the configuration and remembers it, so that a single value can be re-applied
+     * without running every handler through apply_config_logic.
+     */
+    void register_config_handler(const std::string &section, const std::string &key,
+                                 std::function<void(const std::string)> handler) {
+        config_handlers[get_config_handler_key(section, key)].push_back(handler);
+        configuration.register_config_handler(section, key, handler);
+    }
+
+    /**
+     * @brief Runs only the handlers registered for the given value.
+     */
+    void run_config_handlers(const std::string &section, const std::string &key, const std::string &value) {
+        auto it = config_handlers.find(get_config_handler_key(section, key));
+        if (it == config_handlers.end()) {
+            return;
+        }
+        for (const auto &handler : it->second) {
+            handler(value);
+        }
+    }
+
+    /**
+     * @brief Rebuilds a ui in place so it shows the current config values.
+     */
+    void rebuild_ui(UIState ui_state) {
+        if (highlighted_search_target.has_value() &&
+            settings_search_targets[highlighted_search_target.value()].ui_state == ui_state) {
+            highlighted_search_target.reset(); // the rebuilt ui shows the plain label
+        }
+        localized_textboxes[Menu::index(ui_state)].clear();
+        focus_targets[Menu::index(ui_state)].clear();
+        sliders[Menu::index(ui_state)].clear();
+        // assigned into the existing member, so state_to_ui and panel_uis keep pointing at it
+        *state_to_ui[Menu::index(ui_state)] = create_ui(ui_state);
+
+        for (std::size_t i = 0; i < Menu::num_states; ++i) {
+            const auto &render_order = Menu::get_render_order(static_cast<UIState>(i));
+            if (std::find(render_order.begin(), render_order.end(), ui_state) != render_order.end()) {
+                build_navigation_graph(static_cast<UIState>(i));
+            }
+        }
+        focused_widget = SpatialNavigationGraph::no_widget; // the layout changed under it
+    }
+
+    /**
+     * @brief The value of every key the menu handles when the key isn't in the config, the same values the uis and
+     * handlers fall back to.
+     */
+    ConfigEntries get_config_defaults() {
+        AudioOutputConfig default_audio_output_config;
+        ConfigEntries defaults = {
+            {"graphics", "resolution", "1280x720"},
+            {"graphics", "fullscreen", "off"},
+            {"graphics", "wireframe", "off"},
+            {"graphics", "field_of_view", "90"},
+            {"graphics", "max_fps", "60"},
+            {"graphics", "quality_preset", "custom"},
+            {"graphics", "render_scale", "100"},
+            {"graphics", "vsync", "on"},
+            {"graphics", "low_latency", "off"},
+            {"graphics", "show_fps", "off"},
+            {"graphics", "show_pos", "off"},
+            {"sound", "output_device", default_audio_output_config.device_name},
+            {"sound", "sample_rate", std::to_string(default_audio_output_config.sample_rate)},
+            {"sound", "buffer_frames", std::to_string(default_audio_output_config.buffer_frames)},
+            {"input", "mouse_sensitivity", "1"},
+            {"input", "mouse_curve", "linear"},
+            {"input", "mouse_curve_exponent", "1"},
+            {"input", "mouse_curve_points", ""},
+            {"input", "mouse_x_scale", "1"},
+            {"input", "mouse_y_scale", "1"},
+        };
+        for (const auto &[bus, key] : sound_bus_config_keys) {
+            defaults.emplace_back("sound", key, "100");
+        }
+        for (const auto &binding : input_binding_settings) {
+            defaults.emplace_back("input", binding.config_key, binding.default_key);
+        }
+        return defaults;
+    }
+
+    /**
+     * @brief Every key the menu handles, the ones read from other inis.
+     */
+    ConfigKeys get_config_keys() {
+        ConfigKeys keys;
+        for (const auto &[section, key, default_value] : get_config_defaults()) {
+            keys.emplace_back(section, key);
+        }
+        return keys;
+    }
+
+    std::optional<std::string> get_config_default(const std::string &section, const std::string &key) {
+        for (const auto &[default_section, default_key, default_value] : get_config_defaults()) {
+            if (default_section == section && default_key == key) {
+                return default_value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Turns changes that remove a key into setting the key's default, Configuration can't remove a key and the
+     * default is what the menu uses when the key is missing. Removals of keys without a known default are dropped.
+     */
+    ConfigEntries resolve_removed_values(const ConfigChanges &changes) {
+        ConfigEntries entries;
+        for (const auto &[section, key, value] : changes) {
+            std::optional<std::string> resolved_value = value.has_value() ? value : get_config_default(section, key);
+            if (resolved_value.has_value()) {
+                entries.emplace_back(section, key, resolved_value.value());
+            }
+        }
+        return entries;
+    }
+
+    /**
+     * @brief The settings uis that display values from the given config section.
+     */
+    std::vector<UIState> get_uis_showing_section(const std::string &section) {
+        if (section == "graphics") {
+            return {UIState::GRAPHICS_SETTINGS};
+        } else if (section == "sound") {
+            return {UIState::SOUND_SETTINGS};
+        } else if (section == "input") {
+            return {UIState::INPUT_SETTINGS, UIState::MOUSE_SETTINGS};
+        }
+        return {};
+    }
+
+    /**
+     * @brief Applies the values of an undo or redo step and journals them, since they are menu edits like any other.
+     */
+    void apply_settings_history_step(const ConfigChanges &changes) {
+        ConfigEntries values = resolve_removed_values(changes);
+        apply_changed_config_values(values);
+        if (settings_journal) {
+            for (const auto &[section, key, value] : values) {
+                settings_journal->append(section, key, value);
+            }
+        }
+    }
+
+    /**
+     * @brief Sets the values that differ from the live ones, runs only their handlers and rebuilds only the uis
+     * showing them.
+     *
+     * @return the number of values that changed
+     */
+    std::size_t apply_changed_config_values(const ConfigEntries &entries) {
+        std::vector<UIState> stale_uis;
+        std::size_t num_changed_values = 0;
+        for (const auto &[section, key, value] : entries) {
+            if (configuration.get_value(section, key) == value) {
+                continue;
+            }
+            num_changed_values++;
+            configuration.set_value(section, key, value);
+            run_config_handlers(section, key, value);
+            for (const auto &ui_state : get_uis_showing_section(section)) {
+                if (std::find(stale_uis.begin(), stale_uis.end(), ui_state) == stale_uis.end()) {
+                    stale_uis.push_back(ui_state);
+                }
+            }
+        }
+        for (const auto &ui_state : stale_uis) {
+            rebuild_ui(ui_state);
+        }
+        return num_changed_values;
+    }
+
+    /**
+     * @brief Applies a config reload from the watcher, only values that differ from the live ones are set and only
+     * their handlers run.
+     */
+    void apply_config_reload_if_ready() {
+        if (config_file_watcher == nullptr) {
+            return;
+        }
+        std::optional<ConfigReload> reload = config_file_watcher->take_reload();
+        if (!reload.has_value()) {
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        // a key deleted from the file goes back to its default, rather than keeping the value it had before
+        std::set<std::pair<std::string, std::string>> reloaded_keys;
+        for (const auto &[section, key, value] : reload->entries) {
+            reloaded_keys.emplace(section, key);
+        }
+        for (const auto &[section, key, default_value] : get_config_defaults()) {
+            if (reloaded_keys.count({section, key}) == 0 && configuration.get_value(section, key).has_value()) {
+                reload->entries.emplace_back(section, key, default_value);
+            }
+        }
+        std::size_t num_changed_values = apply_changed_config_values(reload->entries);
+        double apply_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        logger.info("reloaded the config file, {} values changed, parsing took {:.2f}ms and applying took {:.2f}ms",
+                    num_changed_values, reload->parse_ms, apply_ms);
+        config_reload_timings.push_back({reload->parse_ms, apply_ms, num_changed_values});
+        if (config_reload_timings.size() > 32) {
+            config_reload_timings.pop_front();
+        }
+    }
+
+    /**
+     * @brief Opens the journal next to the config file and applies the changes it holds to the configuration.
+     *
+     * @note called from the constructor's init list before the uis are built, so it only touches members declared
+     * above settings_journal.
+     */
+    std::unique_ptr<SettingsJournal> open_settings_journal(const std::string &config_file_path) {
+        if (config_file_path.empty()) {
+            return nullptr;
+        }
+        auto journal = std::make_unique<SettingsJournal>(config_file_path + ".journal", config_file_path);
+        std::size_t num_replayed_journal_entries = 0;
+        for (const auto &[section, key, value] : journal->read_entries()) {
+            configuration.set_value(section, key, value);
+            num_replayed_journal_entries++;
+        }
+        if (num_replayed_journal_entries > 0) {
+            logger.info("replayed {} settings changes from the journal", num_replayed_journal_entries);
+            journal->request_compaction();
+        }
+        return journal;
+    }
+
+    /**
+     * @brief Sets a value in the configuration, records it so it can be undone and journals the change so it
+     * survives a crash before the next save.
+     */
+    void set_config_value(const std::string &section, const std::string &key, const std::string &value) {
+        std::optional<std::string> old_value = configuration.get_value(section, key);
+        if (old_value != value) {
+            settings_history.record({section, key}, old_value, value);
+        }
+        configuration.set_value(section, key, value);
+        if (settings_journal) {
+            settings_journal->append(section, key, value);
+        }
+    }
+
+    /**
+     * @brief Saves the config to its ini, while a profile is active its values are saved to the profile's ini instead
+     * and the base ini keeps the values the profile covers up.
+     */
+    void save_config_to_file() {
+        auto get_live_value = [this](const std::string &section, const std::string &key) {
+            return configuration.get_value(section, key);
+        };
+        settings_profiles.save_active_profile(get_live_value);
+
+        auto save_to_file = [this] {
+            ConfigChanges base_values;
+            for (const auto &[section_key, base_value] : settings_profiles.get_base_values()) {
+                base_values.emplace_back(section_key.first, section_key.second, base_value);
+            }
+            // swapped in without running handlers, the live values are put straight back after saving
+            for (const auto &[section, key, value] : resolve_removed_values(base_values)) {
+                configuration.set_value(section, key, value);
+            }
+            configuration.save_to_file();
+            for (const auto &[section_key, value] : settings_profiles.get_active_values()) {
+                configuration.set_value(section_key.first, section_key.second, value);
+            }
+        };
+        if (settings_journal) {
+            settings_journal->save_config(save_to_file);
+        } else {
+            save_to_file();
+        }
+    }
+
+    std::optional<std::string> get_config_value(const std::string &section, const std::string &key) {
+        return configuration.get_value(section, key);
+    }
+
+    /**
+     * @brief Resolves a key string such as "left_shift" to its EKey, this is a linear search so it is only used when
+     * bindings change, never per tick.
+     */
+    std::optional<EKey> key_string_to_key(const std::string &key_str) {
+        for (const auto &key : input_state.all_keys) {
+            if (key.string_repr == key_str) {
+                return key.key_enum;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::string key_to_key_string(EKey key_enum) {
+        for (const auto &key : input_state.all_keys) {
+            if (key.key_enum == key_enum) {
+                return key.string_repr;
+            }
+        }
+        return "unknown";
+    }
+
+    bool is_modifier_key(const std::string &key_str) {
+        return std::find(modifier_key_strings.begin(), modifier_key_strings.end(), key_str) !=
+               modifier_key_strings.end();
+    }
+
+    /**
+     * @brief Parses a binding value such as "w, left_control+up" into its chords, invalid chords are skipped.
+     */
+    std::vector<KeyChord> parse_key_chords(const std::string &value) {
+        std::vector<KeyChord> chords;
+        std::stringstream chords_stream(value);
+        std::string chord_str;
+        while (std::getline(chords_stream, chord_str, ',')) {
+            std::vector<EKey> keys;
+            bool valid = true;
+            std::stringstream keys_stream(chord_str);
+            std::string key_str;
+            while (std::getline(keys_stream, key_str, '+')) {
+                key_str.erase(0, key_str.find_first_not_of(' '));
+                key_str.erase(key_str.find_last_not_of(' ') + 1);
+                std::optional<EKey> key = key_string_to_key(key_str);
+                if (!key.has_value()) {
+                    logger.warn("{} is not a valid key string, skipping the binding {}", key_str, chord_str);
+                    valid = false;
+                    break;
+                }
+                keys.push_back(key.value());
+            }
+            if (valid && !keys.empty()) {
+                EKey key = keys.back();
+                keys.pop_back();
+                chords.emplace_back(key, keys);
+            }
+        }
+        return chords;
+    }
+
+    std::string key_chord_to_string(const KeyChord &chord) {
+        std::string chord_str;
+        for (const auto &modifier : chord.modifiers) {
+            chord_str += key_to_key_string(modifier) + "+";
+        }
+        return chord_str + key_to_key_string(chord.key);
+    }
+
+    std::string key_chords_to_string(const std::vector<KeyChord> &chords) {
+        std::string chords_str;
+        for (const auto &chord : chords) {
+            chords_str += (chords_str.empty() ? "" : ", ") + key_chord_to_string(chord);
+        }
+        return chords_str.empty() ? "unbound" : chords_str;
+    }
+
+    void bind_chords(InputAction action, std::vector<KeyChord> chords) {
+        bound_chords[static_cast<std::size_t>(action)] = std::move(chords);
+        if (!input_binding_table.compile(bound_chords)) {
+            logger.warn("the same key is bound to more than one action, only the first one will be used");
+        }
+    }
+
+    /**
+     * @brief Finishes a capture by binding the chord, unless it is already bound to another action.
+     */
+    void finish_key_capture(const KeyChord &chord) {
+        InputAction action = capturing_action.value();
+        std::size_t action_idx = static_cast<std::size_t>(action);
+        const InputBindingSetting &binding = input_binding_settings[action_idx];
+        capturing_action.reset();
+        captured_modifier.reset();
+        pop_modal();
+
+        std::optional<InputAction> conflict = input_binding_table.find_conflict(chord, action);
+        if (conflict.has_value()) {
+            const std::string &conflict_label = input_binding_settings[static_cast<std::size_t>(*conflict)].label;
+            logger.warn("{} is already bound to {}, not binding it to {}", key_chord_to_string(chord), conflict_label,
+                        binding.label);
+            input_settings_ui.modify_text_of_a_textbox(binding_textbox_ids[action_idx],
+                                                       "conflicts with " + conflict_label);
+            return;
+        }
+
+        std::vector<KeyChord> chords;
+        if (capture_adds_binding) {
+            chords = bound_chords[action_idx];
+        }
+        if (std::find(chords.begin(), chords.end(), chord) == chords.end()) {
+            chords.push_back(chord);
+        }
+
+        std::string chords_str = key_chords_to_string(chords);
+        set_config_value("input", binding.config_key, chords_str);
+        bind_chords(action, chords);
+        input_settings_ui.modify_text_of_a_textbox(binding_textbox_ids[action_idx], chords_str);
+        play_ui_sound(SoundType::CLICK);
+    }
+
+    /**
+     * @brief While a binding is being captured, binds the first chord pressed to it.
+     *
+     * A chord ends at the first non modifier key pressed, the modifiers held at that moment become part of it. A
+     * modifier released without pressing anything else is bound on its own. BACKSPACE cancels the capture instead.
+     *
+     * @return true if input was consumed by the capture this tick.
+     */
+    bool process_key_capture() {
+        if (!capturing_action.has_value()) {
+            return false;
+        }
+
+        if (input_state.is_just_pressed(EKey::BACKSPACE)) {
+            capturing_action.reset();
+            captured_modifier.reset();
+            pop_modal();
+            return true;
+        }
+
+        std::vector<EKey> held_modifiers;
+        for (const auto &modifier_str : modifier_key_strings) {
+            std::optional<EKey> modifier = key_string_to_key(modifier_str);
+            if (modifier.has_value() && input_state.is_pressed(modifier.value())) {
+                held_modifiers.push_back(modifier.value());
+            }
+        }
+
+        for (const auto &key : input_state.all_keys) {
+            if (!input_state.is_just_pressed(key.key_enum)) {
+                continue;
+            }
+            if (is_modifier_key(key.string_repr)) {
+                captured_modifier = key.key_enum;
+                continue;
+            }
+            finish_key_capture(KeyChord(key.key_enum, held_modifiers));
+            return true;
+        }
+
+        if (captured_modifier.has_value() && !input_state.is_pressed(captured_modifier.value())) {
+            finish_key_capture(KeyChord(captured_modifier.value(), held_modifiers));
+            return true;
+        }
+
+        return captured_modifier.has_value();
+    }
+
+    float parse_float_or_default(const std::optional<std::string> &value, float default_value) {
+        if (!value.has_value()) {
+            return default_value;
+        }
+        try {
+            return std::stof(value.value());
+        } catch (const std::exception &) {
+            logger.warn("{} is not a valid number, using {} instead", value.value(), default_value);
+            return default_value;
+        }
+    }
+
+    /**
+     * @brief Rebuilds the mouse sensitivity lookup table from all the mouse settings at once.
+     *
+     * @note custom curve points are stored as "speed:gain" pairs separated by commas, eg "0:1, 20:1.5, 60:2".
+     */
+    void compile_mouse_sensitivity_curve() {
+        std::string curve = get_config_value("input", "mouse_curve").value_or("linear");
+        SensitivityCurveType type = SensitivityCurveType::LINEAR;
+        if (curve == "power") {
+            type = SensitivityCurveType::POWER;
+        } else if (curve == "custom") {
+            type = SensitivityCurveType::CUSTOM;
+        }
+
+        std::vector<std::pair<float, float>> custom_points;
+        std::stringstream points_stream(get_config_value("input", "mouse_curve_points").value_or(""));
+        std::string point_str;
+        while (std::getline(points_stream, point_str, ',')) {
+            size_t colon_pos = point_str.find(':');
+            if (colon_pos == std::string::npos) {
+                logger.warn("{} is not a valid curve point, it should look like speed:gain", point_str);
+                continue;
+            }
+            custom_points.emplace_back(parse_float_or_default(point_str.substr(0, colon_pos), 0),
+                                       parse_float_or_default(point_str.substr(colon_pos + 1), 1));
+        }
+
+        float exponent =
+            std::clamp(parse_float_or_default(get_config_value("input", "mouse_curve_exponent"), 1), 0.5f, 3.0f);
+        mouse_sensitivity_curve.compile(
+            type, parse_float_or_default(get_config_value("input", "mouse_sensitivity"), 1),
+            parse_float_or_default(get_config_value("input", "mouse_x_scale"), 1),
+            parse_float_or_default(get_config_value("input", "mouse_y_scale"), 1), exponent, custom_points);
+        game_settings.mouse_sensitivity_curve = mouse_sensitivity_curve;
+        game_settings_publisher.publish(game_settings);
+    }
+
+    static std::optional<std::pair<unsigned int, unsigned int>> parse_resolution(const std::string &resolution) {
+        size_t x_pos = resolution.find('x');
+        if (x_pos == std::string::npos) {
+            return std::nullopt;
+        }
+        try {
+            return std::make_pair(static_cast<unsigned int>(std::stoul(resolution.substr(0, x_pos))),
+                                  static_cast<unsigned int>(std::stoul(resolution.substr(x_pos + 1))));
+        } catch (const std::exception &) {
+            return std::nullopt;
+        }
+    }
+
+    /**
+     * @brief Returns the cached graphics benchmark score, running the benchmark and caching the score if there is none.
+     *
+     * @note the score isn't a setting, so it isn't undoable, but it is journaled and folded into the ini right away so
+     * the benchmark doesn't run again on the next start without a SAVE. Without a config_file_path there is no ini to
+     * write to and it is only written out with the next save.
+     */
+    double get_or_run_graphics_benchmark() {
+        std::optional<std::string> cached_score = get_config_value("graphics", "benchmark_score");
+        if (cached_score.has_value()) {
+            float score = parse_float_or_default(cached_score, 0);
+            if (score > 0) {
+                return score;
+            }
+        }
+
+        double score = GraphicsBenchmark::run();
+        logger.info("ran the graphics benchmark, scored {:.0f} pixels per second", score);
+        std::string score_value = std::to_string(static_cast<long long>(score));
+        configuration.set_value("graphics", "benchmark_score", score_value);
+        if (settings_journal) {
+            settings_journal->append("graphics", "benchmark_score", score_value);
+            settings_journal->request_compaction();
+        }
+        return score;
+    }
+
+    /**
+     * @brief Picks the largest resolution whose estimated frame time fits within the max_fps budget.
+     */
+    std::string pick_auto_resolution() {
+        double score = get_or_run_graphics_benchmark();
+        float max_fps = std::max(1.0f, parse_float_or_default(get_config_value("graphics", "max_fps"), 60));
+        double frame_budget_seconds = 1.0 / max_fps;
+
+        std::string chosen = resolution_options.front();
+        for (const auto &resolution : resolution_options) {
+            auto dimensions = parse_resolution(resolution);
+            if (dimensions.has_value() &&
+                GraphicsBenchmark::estimate_frame_time_seconds(score, dimensions->first, dimensions->second) <=
+                    frame_budget_seconds) {
+                chosen = resolution;
+            }
+        }
+        return chosen;
+    }
+
+    /**
+     * @brief Applies a quality preset, "low", "medium" and "high" pick a resolution from the bottom, middle and top of
+     * the available ones, "auto" picks one using the graphics benchmark and "custom" leaves everything alone.
+     */
+    void apply_quality_preset(const std::string &preset) {
+        if (resolution_options.empty() || preset == "custom") {
+            return;
+        }
+
+        std::string resolution;
+        if (preset == "low") {
+            resolution = resolution_options.front();
+        } else if (preset == "medium") {
+            resolution = resolution_options[resolution_options.size() / 2];
+        } else if (preset == "high") {
+            resolution = resolution_options.back();
+        } else if (preset == "auto") {
+            resolution = pick_auto_resolution();
+        } else {
+            logger.warn("{} is not a valid quality preset", preset);
+            return;
+        }
+
+        if (get_config_value("graphics", "resolution") != resolution) {
+            logger.info("quality preset {} selected resolution {}", preset, resolution);
+            set_config_value("graphics", "resolution", resolution);
+            window_mode_transaction.stage_resolution(resolution);
+        }
+    }
+
+    static std::string format_field_of_view(float degrees) { return fmt::format("{:.0f} degrees", degrees); }
+
+    /**
+     * @brief Clamps and applies a field of view, without writing it to the config.
+     */
+    void set_field_of_view(float degrees) {
+        degrees = std::clamp(degrees, min_field_of_view_degrees, max_field_of_view_degrees);
+        if (degrees == field_of_view_degrees) {
+            return;
+        }
+        field_of_view_degrees = degrees;
+        on_field_of_view_change(degrees);
+        game_settings.field_of_view_degrees = degrees;
+        game_settings_publisher.publish(game_settings);
+    }
+
+    /**
+     * @brief Adds a slider for a config value, the value is shown in value_rect and the track is drawn at track_rect.
+     *
+     * @param title shown above the values in the list popup
+     * @param get_value the applied value, kept up to date by the key's handlers
+     * @param list_step the spacing of the values offered when the slider is confirmed with the keyboard or d-pad,
+     * which opens them in a list popup
+     * @note values are whole numbers, dragging rounds to the nearest one.
+     */
+    void add_slider(UI &ui, UIState ui_state, const std::string &title, const std::string &section,
+                    const std::string &key, float min_value, float max_value, float list_step,
+                    const vertex_geometry::Rectangle &value_rect, const vertex_geometry::Rectangle &track_rect,
+                    std::function<float()> get_value, std::function<std::string(float)> format_value) {
+        MenuSlider slider{section, key, min_value, max_value, track_rect, -1, std::move(get_value),
+                          std::move(format_value), false, std::nullopt, nullptr, {}};
+        slider.value_textbox_id = ui.add_textbox(slider.format_value(slider.get_value()), value_rect, colors::grey);
+        ui.add_colored_rectangle(track_rect, colors::lightgrey);
+        update_slider_display(ui, slider);
+
+        std::vector<float> list_values;
+        std::vector<std::string> list_items;
+        for (float value = min_value; value <= max_value; value += list_step) {
+            list_values.push_back(value);
+            list_items.push_back(slider.format_value(value));
+        }
+        std::function<void()> open_as_list = [this, title, section, key, list_values, list_items, min_value,
+                                              list_step, get_value = slider.get_value]() {
+            play_ui_sound(SoundType::CLICK);
+            long selected_step = std::lround((get_value() - min_value) / list_step);
+            auto selected_item = static_cast<std::size_t>(std::max(0L, selected_step));
+            push_list_popup(localize(TextId(title)), list_items, std::min(selected_item, list_items.size() - 1),
+                            [this, section, key, list_values](std::size_t idx) {
+                                std::string value = std::to_string(std::lround(list_values[idx]));
+                                set_config_value(section, key, value);
+                                run_config_handlers(section, key, value);
+                            });
+        };
+        focus_targets[Menu::index(ui_state)].push_back({track_rect, std::move(open_as_list)});
+        sliders[Menu::index(ui_state)].push_back(std::move(slider));
+    }
+
+    /**
+     * @brief Moves the handle and rewrites the textbox of the slider if its value changed since they were built.
+     */
+    void update_slider_display(UI &ui, MenuSlider &slider) {
+        float value = slider.get_value();
+        if (slider.shown_value == value) {
+            return;
+        }
+        slider.shown_value = value;
+        ui.modify_text_of_a_textbox(slider.value_textbox_id, slider.format_value(value));
+
+        const auto &track = slider.track;
+        float t = std::clamp((value - slider.min_value) / (slider.max_value - slider.min_value), 0.0f, 1.0f);
+        float handle_width = track.height / 2;
+        float handle_x = track.center.x - track.width / 2 + handle_width / 2 + t * (track.width - handle_width);
+        vertex_geometry::Rectangle handle_rect(glm::vec3(handle_x, track.center.y, 0), handle_width, track.height);
+
+        slider.handle_ui = std::make_unique<UI>(
+            -0.15, batcher.absolute_position_with_colored_vertex_shader_batcher.object_id_generator);
+        slider.handle_ui->add_colored_rectangle(handle_rect, colors::orange);
+        slider.handle_coverage = {handle_rect, {handle_rect}};
+    }
+
+    /**
+     * @brief Stops a drag that was interrupted by leaving the panel or a modal opening, the previewed value is dropped
+     * in favour of the one in the config.
+     */
+    void cancel_slider_drag(MenuSlider &slider) {
+        if (!std::exchange(slider.dragging, false)) {
+            return;
+        }
+        std::optional<std::string> value = get_config_value(slider.section, slider.key);
+        if (!value.has_value()) {
+            value = get_config_default(slider.section, slider.key);
+        }
+        if (value.has_value()) {
+            run_config_handlers(slider.section, slider.key, value.value());
+        }
+    }
+
+    /**
+     * @brief Drags the sliders of the current state's uis and keeps every one of them showing its value.
+     *
+     * @param receives_input false when something above the sliders has the mouse, any drag is cancelled then
+     * @return true if a slider consumed the mouse this tick.
+     */
+    bool process_sliders(const glm::vec2 &acnmp, bool receives_input) {
+        bool input_consumed = false;
+        for (std::size_t i = 0; i < Menu::num_states; ++i) {
+            const auto &render_order = Menu::get_render_order(curr_state);
+            bool drawn = std::find(render_order.begin(), render_order.end(), static_cast<UIState>(i)) !=
+                         render_order.end();
+            for (MenuSlider &slider : sliders[i]) {
+                if (!drawn || !receives_input) {
+                    cancel_slider_drag(slider);
+                } else if (!input_consumed) {
+                    input_consumed = process_slider_drag(acnmp, slider);
+                }
+                if (drawn) {
+                    update_slider_display(*state_to_ui[i], slider);
+                }
+            }
+        }
+        return input_consumed;
+    }
+
+    /**
+     * @return true if the slider consumed the mouse this tick.
+     */
+    bool process_slider_drag(const glm::vec2 &acnmp, MenuSlider &slider) {
+        const auto &rect = slider.track;
+        float left = rect.center.x - rect.width / 2;
+
+        if (!slider.dragging) {
+            bool inside = std::abs(acnmp.x - rect.center.x) <= rect.width / 2 &&
+                          std::abs(acnmp.y - rect.center.y) <= rect.height / 2;
+            if (!inside || !input_state.is_just_pressed(EKey::LEFT_MOUSE_BUTTON)) {
+                return false;
+            }
+            slider.dragging = true;
+        }
+
+        if (!input_state.is_pressed(EKey::LEFT_MOUSE_BUTTON)) {
+            slider.dragging = false;
+            set_config_value(slider.section, slider.key, std::to_string(std::lround(slider.get_value())));
+            play_ui_sound(SoundType::CLICK);
+            return true;
+        }
+
+        float t = std::clamp((acnmp.x - left) / rect.width, 0.0f, 1.0f);
+        long value = std::lround(slider.min_value + t * (slider.max_value - slider.min_value));
+        if (value != std::lround(slider.get_value())) {
+            run_config_handlers(slider.section, slider.key, std::to_string(value));
+        }
+        return true;
+    }
+
+    void update_frame_time_targets() {
+        float max_fps = std::max(1.0f, parse_float_or_default(get_config_value("graphics", "max_fps"), 60));
+        dynamic_resolution_controller.set_target_frame_time(1.0 / max_fps);
+        frame_pacer.set_frame_interval(1.0 / max_fps);
+        if (game_settings.max_fps != max_fps) {
+            game_settings.max_fps = max_fps;
+            game_settings_publisher.publish(game_settings);
+        }
+    }
+
+    /**
+     * @brief Whether the current context accepts a negative swap interval.
+     *
+     * Only native wgl and glx contexts can, through their swap_control_tear extensions. Egl clamps the interval to
+     * its minimum of 0, nsgl (macos) and osmesa have no swap interval extensions at all, so those never do.
+     */
+    bool supports_adaptive_vsync() {
+        if (glfwGetWindowAttrib(window.glfw_window, GLFW_CONTEXT_CREATION_API) != GLFW_NATIVE_CONTEXT_API) {
+            return false;
+        }
+        return glfwExtensionSupported("WGL_EXT_swap_control_tear") ||
+               glfwExtensionSupported("GLX_EXT_swap_control_tear");
+    }
+
+    /**
+     * @brief Sets the swap interval of the current context, "adaptive" only tears when a frame misses vsync and falls
+     * back to "on" if the driver doesn't support it.
+     */
+    void apply_vsync(const std::string &value) {
+        if (value == "off") {
+            glfwSwapInterval(0);
+        } else if (value == "on") {
+            glfwSwapInterval(1);
+        } else if (value == "adaptive") {
+            bool supports_tear_control = supports_adaptive_vsync();
+            if (!supports_tear_control) {
+                logger.warn("adaptive vsync isn't supported by this context, using regular vsync instead");
+            }
+            glfwSwapInterval(supports_tear_control ? -1 : 1);
+        } else {
+            logger.warn("{} is not a valid vsync mode", value);
+        }
+    }
+
+    /**
+     * @brief Refreshes the render scale readouts in the advanced settings, only touching the text that changed.
+     */
+    void update_render_scale_stats() {
+        std::string render_scale = fmt::format("{:.0f}%", get_render_scale() * 100);
+        if (render_scale != displayed_render_scale) {
+            displayed_render_scale = render_scale;
+            advanced_settings_ui.modify_text_of_a_textbox(render_scale_textbox_id, render_scale);
+        }
+
+        std::string state =
+            adaptive_render_scale
+                ? fmt::format("{} ({:.1f} ms avg)",
+                              DynamicResolutionController::state_to_string(dynamic_resolution_controller.get_state()),
+                              dynamic_resolution_controller.get_average_frame_time() * 1000)
+                : "fixed";
+        if (state != displayed_render_scale_state) {
+            displayed_render_scale_state = state;
+            advanced_settings_ui.modify_text_of_a_textbox(render_scale_state_textbox_id, state);
+        }
+    }
+
+    /**
+     * @brief Converts a percentage setting such as "70" into a fraction, used for volumes and the render scale.
+     *
+     * @return the fraction in [0, 1], or 1 if the value is not a number so that a bad config never silences the program
+     */
+    float parse_percentage(const std::string &value) {
+        try {
+            return std::clamp(std::stof(value) / 100.0f, 0.0f, 1.0f);
+        } catch (const std::exception &) {
+            logger.warn("{} is not a valid percentage, using 100 instead", value);
+            return 1.0f;
+        }
+    }
+
+    /**
+     * @brief Parses a whole number above zero, a sample rate or buffer size of 0 or a negative one (which stoul would
+     * happily wrap around) falls back to default_value.
+     */
+    unsigned int parse_positive_or_default(const std::string &value, unsigned int default_value) {
+        try {
+            std::size_t num_parsed_chars = 0;
+            unsigned long parsed = std::stoul(value, &num_parsed_chars);
+            if (value.find('-') == std::string::npos && num_parsed_chars == value.size() && parsed > 0 &&
+                parsed <= std::numeric_limits<unsigned int>::max()) {
+                return static_cast<unsigned int>(parsed);
+            }
+        } catch (const std::exception &) {
+        }
+        logger.warn("{} is not a positive integer, using {} instead", value, default_value);
+        return default_value;
+    }
+
+    /**
+     * @brief Reconfigures the audio backend once, no matter how many of the output settings changed.
+     */
+    void apply_audio_output_config_if_dirty() {
+        if (!audio_output_config_dirty) {
+            return;
+        }
+        audio_output_config_dirty = false;
+        if (audio_backend.reconfigure(audio_output_config)) {
+            logger.info("audio output reconfigured to {} at {}hz with {} buffer frames", audio_output_config.device_name,
+                        audio_output_config.sample_rate, audio_output_config.buffer_frames);
+        } else {
+            logger.warn("audio backend rejected output device {} at {}hz with {} buffer frames",
+                        audio_output_config.device_name, audio_output_config.sample_rate,
+                        audio_output_config.buffer_frames);
+        }
+    }
+
+    /**
+     * @brief Refreshes the underrun and latency readouts in the sound settings, only touching the text that changed.
+     */
+    void update_audio_output_stats() {
+        unsigned int underrun_count = audio_backend.get_underrun_count();
+        if (underrun_count != displayed_underrun_count) {
+            displayed_underrun_count = underrun_count;
+            sound_settings_ui.modify_text_of_a_textbox(underrun_textbox_id, std::to_string(underrun_count));
+        }
+
+        double output_latency_ms = audio_backend.get_output_latency_ms();
+        if (output_latency_ms != displayed_output_latency_ms) {
+            displayed_output_latency_ms = output_latency_ms;
+            sound_settings_ui.modify_text_of_a_textbox(output_latency_textbox_id,
+                                                       fmt::format("{:.1f} ms", output_latency_ms));
+        }
+    }
+
+    using Menu = MenuSystem<UIState>;
+
+    /**
+     * @brief Changes the state from a control on the from state's ui, a transition that isn't in
+     * MenuStateTable<UIState> doesn't compile.
+     */
+    template <UIState from, UIState to> void transition() {
+        static_assert(Menu::transition_allowed(from, to), "this ui state transition is not in MenuStateTable<UIState>");
+        navigate(Menu::index(from), Menu::index(to));
+    }
+
+    MenuPanelId get_current_panel() const {
+        // the host may have set curr_state itself since the registered panel was opened
+        if (curr_registered_panel.has_value() &&
+            curr_state == registered_panels[*curr_registered_panel - Menu::num_states]->drawn_over_state) {
+            return curr_registered_panel.value();
+        }
+        return Menu::index(curr_state);
+    }
+
+    void set_current_panel(MenuPanelId panel) {
+        if (panel < Menu::num_states) {
+            curr_state = static_cast<UIState>(panel);
+            curr_registered_panel.reset();
+            return;
+        }
+        curr_state = registered_panels[panel - Menu::num_states]->drawn_over_state;
+        curr_registered_panel = panel;
+    }
+
+    /**
+     * @brief Moves to the panel to from a control on the from panel.
+     *
+     * When from is the current panel, BACK returns to it afterwards. When from is only drawn behind the current panel,
+     * eg a settings tab picked while another tab is open, the new panel replaces the current one and every panel
+     * entered over from, so BACK leaves them all.
+     */
+    void navigate(MenuPanelId from, MenuPanelId to) {
+        if (from == get_current_panel() && from != to) {
+            navigation_stack.push_back(from);
+        } else {
+            // the panels entered on top of from are left along with the current one
+            auto is_drawn_over_from = [&](MenuPanelId panel) {
+                const auto &render_order = panel_render_orders[panel];
+                return std::find(render_order.begin(), render_order.end(), from) != render_order.end();
+            };
+            while (!navigation_stack.empty() && is_drawn_over_from(navigation_stack.back())) {
+                navigation_stack.pop_back();
+            }
+        }
+        set_current_panel(to);
+    }
+
+    /**
+     * @brief Returns to the panel the current one was entered from, or the main menu if there is none.
+     */
+    void navigate_back() {
+        if (navigation_stack.empty()) {
+            set_current_panel(Menu::index(UIState::MAIN_MENU));
+            return;
+        }
+        set_current_panel(navigation_stack.back());
+        navigation_stack.pop_back();
+    }
+
+    /**
+     * @brief The area each state's ui draws to and the part of it that is opaque, used to skip uis that are hidden.
+     */
+    MenuLayerCoverage get_state_layer_coverage(UIState ui_state) {
+        vertex_geometry::Rectangle whole_screen(glm::vec3(0, 0, 0), 1000, 1000);
+        vertex_geometry::Rectangle main_settings_rect = settings_menu.at(1);
+        switch (ui_state) {
+        case UIState::SETTINGS_MENU:
+            return {whole_screen, {main_settings_rect}};
+        case UIState::PROGRAM_SETTINGS:
+        case UIState::INPUT_SETTINGS:
+        case UIState::SOUND_SETTINGS:
+        case UIState::GRAPHICS_SETTINGS:
+        case UIState::ADVANCED_SETTINGS:
+        case UIState::MOUSE_SETTINGS:
+            return {main_settings_rect, {}};
+        case UIState::MAIN_MENU:
+        case UIState::ABOUT:
+            return {whole_screen, {}};
+        }
+        return {whole_screen, {}};
+    }
+
+    void push_modal(UI ui, MenuLayerCoverage coverage) {
+        modal_stack.push_back(
+            std::make_unique<MenuModal>(MenuModal{std::move(ui), std::move(coverage), nullptr, {}, false, {}}));
+    }
+
+    void pop_modal() {
+        if (!modal_stack.empty()) {
+            modal_stack.pop_back();
+        }
+    }
+
+    /**
+     * @brief Makes the widget at rect focusable with the arrow keys and d-pad, returns rect so it can be passed
+     * straight on to the ui.
+     */
+    const vertex_geometry::Rectangle &navigable(UIState ui_state, const vertex_geometry::Rectangle &rect) {
+        focus_targets[Menu::index(ui_state)].push_back({rect, nullptr});
+        return rect;
+    }
+
+    /**
+     * @brief Adds a dropdown that can also be used with the keyboard and d-pad, confirming it while it's focused opens
+     * its options in a list popup, since the options the ui drops down aren't focus targets.
+     *
+     * @param title shown above the options in the list popup
+     * @note the other arguments are the ones UI::add_dropdown takes, a pick from the list popup rebuilds the ui so the
+     * dropdown shows it.
+     */
+    void add_navigable_dropdown(UI &ui, UIState ui_state, const std::string &title, std::function<void()> on_click,
+                                std::function<void()> on_hover, int selected_option,
+                                const vertex_geometry::Rectangle &rect, const glm::vec3 &color,
+                                const glm::vec3 &hover_color, std::vector<std::string> options,
+                                std::function<void(std::string)> on_select,
+                                std::function<void(std::string)> on_option_hover) {
+        std::function<void()> open_as_list = [this, ui_state, title, options, selected_option, on_select]() {
+            play_ui_sound(SoundType::CLICK);
+            push_list_popup(localize(TextId(title)), options, static_cast<std::size_t>(std::max(selected_option, 0)),
+                            [this, ui_state, options, on_select](std::size_t idx) {
+                                on_select(options[idx]);
+                                std::size_t picked_from = focused_widget;
+                                rebuild_ui(ui_state);
+                                // the layout is the same, so the dropdown keeps focus
+                                focused_widget = picked_from;
+                            });
+        };
+        focus_targets[Menu::index(ui_state)].push_back({rect, std::move(open_as_list)});
+        ui.add_dropdown(std::move(on_click), std::move(on_hover), selected_option, rect, color, hover_color,
+                        std::move(options), std::move(on_select), std::move(on_option_hover));
+    }
+
+    /**
+     * @brief Links the focus targets of every ui drawn for the state, in render order.
+     */
+    void build_navigation_graph(UIState ui_state) {
+        std::vector<vertex_geometry::Rectangle> widget_rects;
+        std::vector<std::function<void()>> &list_openers = navigation_list_openers[Menu::index(ui_state)];
+        list_openers.clear();
+        for (UIState layer : Menu::get_render_order(ui_state)) {
+            for (const FocusTarget &focus_target : focus_targets[Menu::index(layer)]) {
+                widget_rects.push_back(focus_target.rect);
+                list_openers.push_back(focus_target.open_as_list);
+            }
+        }
+        navigation_graphs[Menu::index(ui_state)].build(std::move(widget_rects));
+    }
+
+    /**
+     * @brief Opens the options of the focused dropdown in a list popup when it's confirmed with ENTER or A.
+     *
+     * @return true if a list was opened, the confirm then shouldn't also click the dropdown.
+     */
+    bool open_focused_dropdown(bool focus_confirmed) {
+        if (!focus_confirmed || !modal_stack.empty() || curr_registered_panel.has_value() ||
+            focused_widget == SpatialNavigationGraph::no_widget) {
+            return false;
+        }
+        const std::vector<std::function<void()>> &list_openers = navigation_list_openers[Menu::index(curr_state)];
+        if (focused_widget >= list_openers.size() || !list_openers[focused_widget]) {
+            return false;
+        }
+        list_openers[focused_widget]();
+        return true;
+    }
+
+    struct GamepadPresses {
+        std::array<bool, 4> dpad = {}; // indexed by SpatialNavigationGraph::Direction
+        bool confirm = false;
+    };
+
+    /**
+     * @brief The d-pad directions and the confirm (A) button pressed on the first gamepad since the last frame.
+     */
+    GamepadPresses poll_gamepad() {
+        GamepadPresses presses;
+        GLFWgamepadstate gamepad_state;
+        if (!glfwJoystickIsGamepad(GLFW_JOYSTICK_1) || !glfwGetGamepadState(GLFW_JOYSTICK_1, &gamepad_state)) {
+            gamepad_dpad_was_pressed = {};
+            gamepad_confirm_was_pressed = false;
+            return presses;
+        }
+        const std::array<int, 4> dpad_buttons = {GLFW_GAMEPAD_BUTTON_DPAD_UP, GLFW_GAMEPAD_BUTTON_DPAD_DOWN,
+                                                 GLFW_GAMEPAD_BUTTON_DPAD_LEFT, GLFW_GAMEPAD_BUTTON_DPAD_RIGHT};
+        for (std::size_t i = 0; i < dpad_buttons.size(); ++i) {
+            bool pressed = gamepad_state.buttons[dpad_buttons[i]] == GLFW_PRESS;
+            presses.dpad[i] = pressed && !gamepad_dpad_was_pressed[i];
+            gamepad_dpad_was_pressed[i] = pressed;
+        }
+        bool confirm_pressed = gamepad_state.buttons[GLFW_GAMEPAD_BUTTON_A] == GLFW_PRESS;
+        presses.confirm = confirm_pressed && !gamepad_confirm_was_pressed;
+        gamepad_confirm_was_pressed = confirm_pressed;
+        return presses;
+    }
+
+    /**
+     * @brief The graph focus moves along right now, the top modal's or the current state's.
+     *
+     * @return nullptr when nothing can be focused, eg a list popup (which handles the arrow keys itself) or a
+     * registered panel is open.
+     */
+    const SpatialNavigationGraph *get_active_navigation_graph() const {
+        const SpatialNavigationGraph *graph = nullptr;
+        if (!modal_stack.empty()) {
+            graph = &modal_stack.back()->navigation_graph;
+        } else if (!curr_registered_panel.has_value()) {
+            graph = &navigation_graphs[Menu::index(curr_state)];
+        }
+        return graph != nullptr && !graph->empty() ? graph : nullptr;
+    }
+
+    /**
+     * @brief Moves focus with the arrow keys and the d-pad, using the mouse again drops it.
+     *
+     * @return the center of the focused widget, the uis are processed as if the mouse was there, or std::nullopt when
+     * nothing is focused.
+     */
+    std::optional<glm::vec2> process_focus_navigation(const glm::vec2 &acnmp, const GamepadPresses &gamepad) {
+        const SpatialNavigationGraph *graph = get_active_navigation_graph();
+        bool mouse_used = acnmp != last_mouse_position || input_state.is_just_pressed(EKey::LEFT_MOUSE_BUTTON);
+        last_mouse_position = acnmp;
+        // a list popup handles the arrow keys itself, the widget that opened it is focused again once it closes
+        bool list_popup_open = !modal_stack.empty() && modal_stack.back()->list != nullptr;
+        if (mouse_used || (graph == nullptr && !list_popup_open)) {
+            focused_widget = SpatialNavigationGraph::no_widget;
+        } else if (graph != nullptr && graph != focused_graph && focused_widget != SpatialNavigationGraph::no_widget) {
+            focused_widget = 0; // keep focusing after moving to another panel or opening a dialog
+        }
+        if (graph == nullptr) {
+            return std::nullopt;
+        }
+        focused_graph = graph;
 
-enum class UIState {
-    // TODO remove the dummy state and fill in with all the states you need
-    MAIN_MENU,
+        const std::array<std::optional<EKey>, 4> direction_keys = {up_key, down_key, left_key, right_key};
+        for (std::size_t direction = 0; direction < direction_keys.size(); ++direction) {
+            bool key_pressed =
+                direction_keys[direction].has_value() && input_state.is_just_pressed(direction_keys[direction].value());
+            if (!key_pressed && !gamepad.dpad[direction]) {
+                continue;
+            }
+            if (focused_widget == SpatialNavigationGraph::no_widget) {
+                focused_widget = 0;
+            } else {
+                std::size_t neighbor =
+                    graph->get_neighbor(focused_widget, static_cast<SpatialNavigationGraph::Direction>(direction));
+                focused_widget = neighbor == SpatialNavigationGraph::no_widget ? focused_widget : neighbor;
+            }
+            break;
+        }
 
-    SETTINGS_MENU,
-    PROGRAM_SETTINGS,
-    INPUT_SETTINGS,
-    SOUND_SETTINGS,
-    GRAPHICS_SETTINGS,
-    ADVANCED_SETTINGS,
+        if (focused_widget == SpatialNavigationGraph::no_widget) {
+            return std::nullopt;
+        }
+        const glm::vec3 &center = graph->get_rect(focused_widget).center;
+        return glm::vec2(center.x, center.y);
+    }
 
-    ABOUT,
-};
+    /**
+     * @brief The text in the current language, or its source text when there is no translation for it.
+     */
+    std::string localize(const TextId &text) const {
+        if (localization_table.has_value()) {
+            if (std::optional<std::string_view> translation = localization_table->find(text)) {
+                return std::string(translation.value());
+            }
+        }
+        return std::string(text.source);
+    }
 
-/**
- * @class InputGraphicsSoundMenu
- * @brief Handles all user interface (UI) states related to input, graphics, and sound configuration.
- *
- * This class manages multiple UI panels including main menu, settings menus, and submenus for
- * sound, graphics, input, and player settings. It integrates input, configuration, sound, and rendering systems
- * to create an interactive settings menu for the engine or game.
- *
- * @note this whole system can be generalized I think because this is just a container holding specific uis and then
- * there's a function that determins what uis need to be drawn
- *
- * @warning The class currently depends on `InputState` only for key validity checks.
- *          This should be removed once key validation is decoupled.
- */
-class InputGraphicsSoundMenu {
-  private:
-    vertex_geometry::Rectangle settings_menu_rect = vertex_geometry::Rectangle(glm::vec3(0, 0, 0), 1.2, 1.2);
-    std::vector<vertex_geometry::Rectangle> settings_menu =
-        weighted_subdivision(settings_menu_rect, {1, 3}, vertex_geometry::CutDirection::horizontal);
+    std::string get_localized_text(const LocalizedTextbox &localized_textbox) const {
+        std::string text = localize(localized_textbox.text);
+        return localized_textbox.wrap == TextWrap::long_lines ? text_utils::add_newlines_to_long_string(text) : text;
+    }
 
-    SoundSystem &sound_system;
-    Batcher &batcher;
-    Configuration &configuration;
-    Window &window;
-    InputState &input_state; // only taking this because of the member function to check if key is valid, remove
-                             // hopefully in future
+    /**
+     * @brief Adds a textbox showing localized text, it is updated in place when the language changes.
+     *
+     * @param layout_args the position arguments add_textbox takes after the text
+     */
+    template <typename... LayoutArgs>
+    int add_localized_textbox(UI &ui, UIState ui_state, const TextId &text, TextWrap wrap,
+                              LayoutArgs &&...layout_args) {
+        const std::string &source = source_texts.try_emplace(text.hash, text.source).first->second;
+        LocalizedTextbox localized_textbox{-1, TextId(std::string_view(source)), wrap};
+        localized_textbox.textbox_id =
+            ui.add_textbox(get_localized_text(localized_textbox), std::forward<LayoutArgs>(layout_args)...);
+        localized_textboxes[Menu::index(ui_state)].push_back(localized_textbox);
+        return localized_textbox.textbox_id;
+    }
 
-    Logger logger = Logger("input_graphics_sound_menu");
+    /**
+     * @brief Rewrites the text of every localized textbox and reindexes the settings search in the current language.
+     */
+    void relayout_localized_text() {
+        for (std::size_t i = 0; i < Menu::num_states; ++i) {
+            for (const LocalizedTextbox &localized_textbox : localized_textboxes[i]) {
+                state_to_ui[i]->modify_text_of_a_textbox(localized_textbox.textbox_id,
+                                                         get_localized_text(localized_textbox));
+            }
+        }
+        highlighted_search_target.reset();
+        settings_search_index = TrigramSearchIndex();
+        for (const SettingsSearchTarget &target : settings_search_targets) {
+            settings_search_index.add(localize(TextId(target.label)));
+        }
+    }
 
-    std::function<void()> on_hover = [&]() { sound_system.queue_sound(SoundType::HOVER); };
-    std::function<void(const std::string)> dropdown_on_hover = [&](const std::string) {
-        sound_system.queue_sound(SoundType::HOVER);
-    };
+    /**
+     * @brief Adds a setting's label to the ui and makes it findable through the settings search.
+     */
+    int add_searchable_label(UI &ui, UIState ui_state, const std::string &label,
+                             const vertex_geometry::Rectangle &rect) {
+        int textbox_id = add_localized_textbox(ui, ui_state, TextId(label), TextWrap::none, rect, colors::maroon);
+        auto [target_id, added] =
+            settings_search_target_ids.try_emplace({ui_state, label}, settings_search_targets.size());
+        if (added) {
+            settings_search_index.add(localize(TextId(label)));
+            settings_search_targets.push_back({ui_state, label, textbox_id});
+        } else {
+            settings_search_targets[target_id->second].textbox_id = textbox_id;
+        }
+        return textbox_id;
+    }
 
-  public:
-    bool enabled = true;
-    UIState curr_state = UIState::MAIN_MENU;
+    static std::string get_panel_name(UIState ui_state) {
+        switch (ui_state) {
+        case UIState::PROGRAM_SETTINGS:
+            return "player";
+        case UIState::INPUT_SETTINGS:
+            return "input";
+        case UIState::MOUSE_SETTINGS:
+            return "mouse";
+        case UIState::SOUND_SETTINGS:
+            return "sound";
+        case UIState::GRAPHICS_SETTINGS:
+            return "graphics";
+        case UIState::ADVANCED_SETTINGS:
+            return "network";
+        default:
+            return "";
+        }
+    }
 
-    UI main_menu_ui, about_ui, settings_menu_ui, player_settings_ui, input_settings_ui, sound_settings_ui,
-        graphics_settings_ui, advanced_settings_ui;
-
-    std::map<UIState, UI &> game_state_to_ui = {
-        {UIState::MAIN_MENU, main_menu_ui},
-        {UIState::ABOUT, about_ui},
-        {UIState::SETTINGS_MENU, settings_menu_ui},
-        {UIState::PROGRAM_SETTINGS, player_settings_ui},
-        {UIState::INPUT_SETTINGS, input_settings_ui},
-        {UIState::SOUND_SETTINGS, sound_settings_ui},
-        {UIState::GRAPHICS_SETTINGS, graphics_settings_ui},
-        {UIState::ADVANCED_SETTINGS, advanced_settings_ui},
-    };
+    std::vector<std::string> get_settings_search_result_labels() {
+        std::vector<std::string> labels;
+        for (std::size_t target_id : settings_search_results) {
+            const SettingsSearchTarget &target = settings_search_targets[target_id];
+            labels.push_back(localize(TextId(target.label)) + " (" + localize(TextId(get_panel_name(target.ui_state))) +
+                             ")");
+        }
+        return labels;
+    }
 
     /**
-     * @brief Constructs an InputGraphicsSoundMenu and initializes all UIs and configuration handlers.
-     *
-     * @param window Reference to the main Window.
-     * @param input_state Reference to the InputState used for handling input bindings.
-     * @param batcher Reference to the Batcher used for UI rendering.
-     * @param sound_system Reference to the SoundSystem for playing UI sounds.
-     * @param configuration Reference to the Configuration object managing persistent settings.
-     *
-     * @note This constructor also registers configuration handlers for graphics-related settings
-     *       (resolution, fullscreen, wireframe) and applies configuration logic upon initialization.
-     * @throws std::invalid_argument If a configuration handler attempts to parse an invalid setting string.
+     * @brief Opens the search over every settings panel, typing filters the results and picking one goes to it.
      */
-    InputGraphicsSoundMenu(Window &window, InputState &input_state, Batcher &batcher, SoundSystem &sound_system,
-                           Configuration &configuration)
-        : window(window), input_state(input_state), batcher(batcher), sound_system(sound_system),
-          configuration(configuration), main_menu_ui(create_main_menu_ui()), about_ui(create_about_ui()),
-          settings_menu_ui(create_settings_menu_ui()), player_settings_ui(create_player_settings_ui()),
-          input_settings_ui(create_input_settings_ui()), sound_settings_ui(create_sound_settings_ui()),
-          graphics_settings_ui(create_graphics_settings_ui()), advanced_settings_ui(create_advanced_settings_ui()) {
+    void open_settings_search() {
+        settings_search_query.clear();
+        settings_search_results = settings_search_index.search(settings_search_query);
 
-        configuration.register_config_handler("graphics", "resolution",
-                                              [&](const std::string resolution) { window.set_resolution(resolution); });
+        vertex_geometry::Rectangle main_settings_rect = settings_menu.at(1);
+        std::vector<vertex_geometry::Rectangle> query_and_list =
+            weighted_subdivision(main_settings_rect, {1, 10}, vertex_geometry::CutDirection::horizontal);
 
-        configuration.register_config_handler("graphics", "fullscreen",
-                                              [&](const std::string value) { window.set_fullscreen_by_on_off(value); });
+        UI popup_ui(-0.2, batcher.absolute_position_with_colored_vertex_shader_batcher.object_id_generator);
+        popup_ui.add_colored_rectangle(main_settings_rect, colors::grey18);
+        settings_search_query_textbox_id =
+            popup_ui.add_textbox(localize("type to search"), query_and_list.at(0), colors::maroon);
+        auto list = std::make_unique<VirtualizedList>(get_settings_search_result_labels(), 10);
+        list->build(popup_ui, query_and_list.at(1));
 
-        configuration.register_config_handler("graphics", "wireframe", [&](const std::string value) {
-            if (value == "on") {
-                window.enable_wireframe_mode();
-            } else if (value == "off") {
-                window.disable_wireframe_mode();
+        push_modal(std::move(popup_ui), {main_settings_rect, {main_settings_rect}});
+        modal_stack.back()->list = std::move(list);
+        modal_stack.back()->is_settings_search = true;
+        modal_stack.back()->on_list_pick = [this](std::size_t result_idx) {
+            go_to_settings_search_target(settings_search_results[result_idx]);
+        };
+    }
+
+    /**
+     * @brief Edits the query of the settings search when it is the top modal and updates its results.
+     *
+     * @return true if input was consumed by the search this tick.
+     */
+    bool process_settings_search(const std::vector<std::string> &keys_just_pressed) {
+        if (modal_stack.empty() || !modal_stack.back()->is_settings_search) {
+            return false;
+        }
+        MenuModal &popup = *modal_stack.back();
+        std::string query = settings_search_query;
+        for (const auto &key : keys_just_pressed) {
+            if (key.size() == 1 && std::isalnum(static_cast<unsigned char>(key[0]))) {
+                query += key;
+            } else if (key == "space") {
+                query += ' ';
             }
-        });
+        }
+        if (input_state.is_just_pressed(EKey::BACKSPACE)) {
+            if (query.empty()) {
+                pop_modal();
+                return true;
+            }
+            query.pop_back();
+        }
+        if (query == settings_search_query) {
+            return false;
+        }
 
-        configuration.apply_config_logic();
+        settings_search_query = query;
+        settings_search_results = settings_search_index.search(settings_search_query);
+        popup.ui.modify_text_of_a_textbox(settings_search_query_textbox_id,
+                                          query.empty() ? localize("type to search") : query + "_");
+        popup.list->set_items(popup.ui, get_settings_search_result_labels());
+        return false;
+    }
 
-        logger.info("successfully initialized");
-    };
+    /**
+     * @brief Opens the panel holding the setting and highlights its label until another setting is found.
+     */
+    void go_to_settings_search_target(std::size_t target_id) {
+        const SettingsSearchTarget &target = settings_search_targets[target_id];
+        MenuPanelId settings_menu_panel = Menu::index(UIState::SETTINGS_MENU);
+        if (Menu::transition_allowed(UIState::SETTINGS_MENU, target.ui_state)) {
+            navigate(settings_menu_panel, Menu::index(target.ui_state));
+        } else {
+            // panels that aren't tabs, like the mouse settings, are opened through the tab they are reached from
+            for (std::size_t tab = 0; tab < Menu::num_states; ++tab) {
+                if (Menu::transition_allowed(UIState::SETTINGS_MENU, static_cast<UIState>(tab)) &&
+                    Menu::transition_allowed(static_cast<UIState>(tab), target.ui_state)) {
+                    navigate(settings_menu_panel, tab);
+                    navigate(tab, Menu::index(target.ui_state));
+                    break;
+                }
+            }
+        }
+
+        if (highlighted_search_target.has_value()) {
+            const SettingsSearchTarget &previous = settings_search_targets[highlighted_search_target.value()];
+            state_to_ui[Menu::index(previous.ui_state)]->modify_text_of_a_textbox(previous.textbox_id,
+                                                                                  localize(TextId(previous.label)));
+        }
+        state_to_ui[Menu::index(target.ui_state)]->modify_text_of_a_textbox(
+            target.textbox_id, "> " + localize(TextId(target.label)) + " <");
+        highlighted_search_target = target_id;
+    }
 
-  private:
     /**
-     * @brief Retrieves the UIStates that should be rendered alongside a given UI.
+     * @brief Opens a scrolling list of items over the settings panel, the list only builds widgets for its visible
+     * rows so it can hold any number of items.
      *
-     * For example the SOUND_SETTINGS UIState requires the more generic SETTINGS_MENU UIState because it is used as the
-     * background
+     * @param on_pick called with the index of the item picked, the popup is closed first so it may rebuild uis
+     */
+    void push_list_popup(const std::string &title, std::vector<std::string> items, std::size_t selected_item,
+                         std::function<void(std::size_t)> on_pick) {
+        vertex_geometry::Rectangle main_settings_rect = settings_menu.at(1);
+        std::vector<vertex_geometry::Rectangle> title_and_list =
+            weighted_subdivision(main_settings_rect, {1, 10}, vertex_geometry::CutDirection::horizontal);
+
+        UI popup_ui(-0.2, batcher.absolute_position_with_colored_vertex_shader_batcher.object_id_generator);
+        popup_ui.add_colored_rectangle(main_settings_rect, colors::grey18);
+        popup_ui.add_textbox(title + " (" + localize("backspace cancels") + ")", title_and_list.at(0), colors::maroon);
+        auto list = std::make_unique<VirtualizedList>(std::move(items), 10);
+        list->scroll_to(selected_item);
+        list->build(popup_ui, title_and_list.at(1));
+
+        push_modal(std::move(popup_ui), {main_settings_rect, {main_settings_rect}});
+        modal_stack.back()->list = std::move(list);
+        modal_stack.back()->on_list_pick = std::move(on_pick);
+    }
+
+    /**
+     * @brief Scrolls and picks from the list popup on top, if the top modal is one.
      *
-     * @param ui_state The primary UI state for which dependencies are queried.
-     * @return A vector of dependent UIState values that must also be rendered.
+     * @return true if input was consumed by the list this tick.
+     */
+    bool process_list_popup(const glm::vec2 &acnmp, const GamepadPresses &gamepad) {
+        if (modal_stack.empty() || modal_stack.back()->list == nullptr) {
+            pending_list_scroll_rows = 0;
+            return false;
+        }
+        MenuModal &popup = *modal_stack.back();
+        // the settings search uses backspace to edit its query
+        if (!popup.is_settings_search && input_state.is_just_pressed(EKey::BACKSPACE)) {
+            pop_modal();
+            return true;
+        }
+
+        popup.list->scroll_by(std::exchange(pending_list_scroll_rows, 0.0f));
+        if ((up_key.has_value() && input_state.is_just_pressed(up_key.value())) ||
+            gamepad.dpad[static_cast<std::size_t>(SpatialNavigationGraph::Direction::up)]) {
+            popup.list->move_highlight(-1);
+        }
+        if ((down_key.has_value() && input_state.is_just_pressed(down_key.value())) ||
+            gamepad.dpad[static_cast<std::size_t>(SpatialNavigationGraph::Direction::down)]) {
+            popup.list->move_highlight(1);
+        }
+
+        std::optional<std::size_t> picked_item =
+            popup.list->update(popup.ui, acnmp, input_state.is_just_pressed(EKey::LEFT_MOUSE_BUTTON));
+        if (!picked_item.has_value() && (input_state.is_just_pressed(EKey::ENTER) || gamepad.confirm) &&
+            popup.list->get_num_items() > 0) {
+            picked_item = popup.list->get_highlighted_item();
+        }
+        if (picked_item.has_value()) {
+            std::function<void(std::size_t)> on_pick = std::move(popup.on_list_pick);
+            pop_modal();
+            on_pick(picked_item.value());
+        }
+        return true;
+    }
+
+    /**
+     * @brief Opens an opaque prompt over the settings panel, the panel beneath it isn't processed while it's open.
      */
-    std::vector<UIState> get_ui_dependencies(const UIState &ui_state) {
+    void push_key_capture_prompt(const std::string &binding_label) {
+        vertex_geometry::Rectangle main_settings_rect = settings_menu.at(1);
+        UI prompt_ui(-0.2, batcher.absolute_position_with_colored_vertex_shader_batcher.object_id_generator);
+        prompt_ui.add_colored_rectangle(main_settings_rect, colors::grey18);
+        vertex_geometry::Grid prompt_grid(3, 1, main_settings_rect);
+        prompt_ui.add_textbox(localize("press a key for") + " " + localize(TextId(binding_label)),
+                              prompt_grid.get_at(0, 1), colors::maroon);
+        prompt_ui.add_textbox(localize("backspace cancels"), prompt_grid.get_at(0, 2), colors::grey);
+        push_modal(std::move(prompt_ui), {main_settings_rect, {main_settings_rect}});
+    }
+
+    /**
+     * @brief Creates the ui for the given state, used when a ui has to be rebuilt after construction.
+     */
+    UI create_ui(const UIState &ui_state) {
         switch (ui_state) {
         case UIState::MAIN_MENU:
-            return {};
+            return create_main_menu_ui();
         case UIState::SETTINGS_MENU:
-            return {};
+            return create_settings_menu_ui();
         case UIState::PROGRAM_SETTINGS:
-            return {UIState::SETTINGS_MENU};
+            return create_player_settings_ui();
         case UIState::INPUT_SETTINGS:
-            return {UIState::SETTINGS_MENU};
+            return create_input_settings_ui();
         case UIState::SOUND_SETTINGS:
-            return {UIState::SETTINGS_MENU};
+            return create_sound_settings_ui();
         case UIState::GRAPHICS_SETTINGS:
-            return {UIState::SETTINGS_MENU};
+            return create_graphics_settings_ui();
         case UIState::ADVANCED_SETTINGS:
-            return {UIState::SETTINGS_MENU};
+            return create_advanced_settings_ui();
+        case UIState::MOUSE_SETTINGS:
+            return create_mouse_settings_ui();
         case UIState::ABOUT:
-            return {};
-            break;
+            return create_about_ui();
         }
-        return {};
+        return create_main_menu_ui();
     }
 
   public:
@@ -167,20 +5299,95 @@ class InputGraphicsSoundMenu {
             window.convert_point_from_2d_screen_space_to_2d_aspect_corrected_normalized_screen_space(
                 input_state.mouse_position_x, input_state.mouse_position_y));
 
-        std::vector<UIState> uis_to_render = {curr_state};
-        for (const auto &ui_state : get_ui_dependencies(curr_state)) {
-            uis_to_render.push_back(ui_state);
+        apply_config_reload_if_ready();
+        if (pending_settings_profile.has_value()) {
+            switch_settings_profile(std::exchange(pending_settings_profile, std::nullopt).value());
+        }
+        // before the step is committed so the resolution it sets is undone along with the preset
+        if (pending_quality_preset.has_value()) {
+            apply_quality_preset(std::exchange(pending_quality_preset, std::nullopt).value());
+        }
+        // everything set during the last frame was caused by one interaction, so it is undone as one step
+        settings_history.commit_step();
+        if (std::exchange(undo_requested, false)) {
+            undo_settings_change();
+        }
+        if (std::exchange(redo_requested, false)) {
+            redo_settings_change();
+        }
+        for (; num_modal_closes_requested > 0; num_modal_closes_requested--) {
+            pop_modal();
+        }
+        window_mode_transaction.commit_if_settled();
+        apply_audio_output_config_if_dirty();
+        if (std::exchange(sound_settings_ui_stale, false)) {
+            rebuild_ui(UIState::SOUND_SETTINGS);
+        }
+        if (std::exchange(built_in_text_stale, false)) {
+            for (UIState ui_state : uis_with_built_in_text) {
+                rebuild_ui(ui_state);
+            }
+        }
+        if (curr_state == UIState::SOUND_SETTINGS) {
+            update_audio_output_stats();
+        }
+        if (curr_state == UIState::ADVANCED_SETTINGS) {
+            update_render_scale_stats();
+        }
+
+        // the key that was just bound, or the slider being dragged, shouldn't also interact with the rest of the ui
+        std::vector<std::string> keys_just_pressed = input_state.get_keys_just_pressed_this_tick();
+        GamepadPresses gamepad = poll_gamepad();
+        std::optional<glm::vec2> focus_position = process_focus_navigation(acnmp, gamepad);
+        // a focused widget is hovered and clicked (with ENTER or A) as if the mouse was over it
+        glm::vec2 pointer_position = focus_position.value_or(acnmp);
+        bool focus_confirmed =
+            focus_position.has_value() && (input_state.is_just_pressed(EKey::ENTER) || gamepad.confirm);
+        bool clicked = input_state.is_just_pressed(EKey::LEFT_MOUSE_BUTTON) || focus_confirmed;
+        // a dropdown opened here has its list processed from the next frame, so this confirm doesn't also pick from it
+        bool input_consumed = process_key_capture() || process_settings_search(keys_just_pressed) ||
+                              process_list_popup(acnmp, gamepad) || open_focused_dropdown(focus_confirmed);
+        bool sliders_receive_input = !input_consumed && modal_stack.empty() && !curr_registered_panel.has_value();
+        input_consumed = process_sliders(acnmp, sliders_receive_input) || input_consumed;
+
+        const std::vector<std::string> no_keys_pressed;
+        glm::vec2 off_screen_position(-10, -10); // nothing hovers
+
+        // back to front, the current state's uis in their cached render order and then the modals above them
+        frame_layers.clear();
+        for (MenuPanelId panel : panel_render_orders[get_current_panel()]) {
+            frame_layers.push_back({panel_uis[panel], &panel_coverages[panel], true});
+            if (panel < Menu::num_states) {
+                for (const MenuSlider &slider : sliders[panel]) {
+                    frame_layers.push_back({slider.handle_ui.get(), &slider.handle_coverage, true});
+                }
+            }
+        }
+        for (const auto &modal : modal_stack) {
+            frame_layers.push_back({&modal->ui, &modal->coverage, true});
         }
 
-        for (const auto &ui_state : uis_to_render) {
-            if (game_state_to_ui.find(ui_state) != game_state_to_ui.end()) {
-                UI &selected_ui = game_state_to_ui.at(ui_state);
+        // hidden layers are found front to back, then the rest are processed back to front so they batch in painter's
+        // order
+        frame_opaque_rects.clear();
+        for (auto layer = frame_layers.rbegin(); layer != frame_layers.rend(); ++layer) {
+            layer->visible = !layer->coverage->is_hidden_by(frame_opaque_rects);
+            frame_opaque_rects.insert(frame_opaque_rects.end(), layer->coverage->opaque_rects.begin(),
+                                      layer->coverage->opaque_rects.end());
+        }
 
-                process_and_queue_render_ui(
-                    acnmp, selected_ui, ui_render_suite, input_state.get_keys_just_pressed_this_tick(),
-                    input_state.is_just_pressed(EKey::BACKSPACE), input_state.is_just_pressed(EKey::ENTER),
-                    input_state.is_just_pressed(EKey::LEFT_MOUSE_BUTTON));
+        for (std::size_t i = 0; i < frame_layers.size(); ++i) {
+            const FrameLayer &layer = frame_layers[i];
+            if (!layer.visible) {
+                continue;
             }
+            // only the top most layer gets input while a modal is open
+            bool receives_input = !input_consumed && (modal_stack.empty() || i + 1 == frame_layers.size());
+            process_and_queue_render_ui(receives_input ? pointer_position : off_screen_position, *layer.ui,
+                                        ui_render_suite, receives_input ? keys_just_pressed : no_keys_pressed,
+                                        receives_input && input_state.is_just_pressed(EKey::BACKSPACE),
+                                        receives_input && input_state.is_just_pressed(EKey::ENTER),
+                                        receives_input && clicked);
         }
     }
 
@@ -196,47 +5403,52 @@ class InputGraphicsSoundMenu {
     UI create_main_menu_ui() {
 
         std::function<void()> on_program_start = [&]() {
-            sound_system.queue_sound(SoundType::CLICK);
+            play_ui_sound(SoundType::CLICK);
             enabled = false;
         };
         std::function<void()> on_click_settings = [&]() {
-            sound_system.queue_sound(SoundType::CLICK);
-            curr_state = UIState::PROGRAM_SETTINGS;
+            play_ui_sound(SoundType::CLICK);
+            transition<UIState::MAIN_MENU, UIState::PROGRAM_SETTINGS>();
         };
         std::function<void()> on_click_about = [&]() {
-            sound_system.queue_sound(SoundType::CLICK);
-            curr_state = UIState::ABOUT;
+            play_ui_sound(SoundType::CLICK);
+            transition<UIState::MAIN_MENU, UIState::ABOUT>();
         };
         std::function<void()> on_game_quit = [&]() {
-            sound_system.queue_sound(SoundType::CLICK);
-            glfwSetWindowShouldClose(window.glfw_window, GLFW_TRUE);
+            play_ui_sound(SoundType::CLICK);
+            push_confirmation_dialog(localize("quit the game?"),
+                                     [this]() { glfwSetWindowShouldClose(window.glfw_window, GLFW_TRUE); });
         };
         std::function<void()> on_back_clicked = [&]() {
-            sound_system.queue_sound(SoundType::CLICK);
-            curr_state = UIState::MAIN_MENU;
+            play_ui_sound(SoundType::CLICK);
+            transition<UIState::MAIN_MENU, UIState::MAIN_MENU>();
         };
 
         // UIRenderSuiteImpl ui_render_suite(batcher);
 
         // main menu ui
         UI main_menu_ui(0, batcher.absolute_position_with_colored_vertex_shader_batcher.object_id_generator);
-        main_menu_ui.add_textbox("Welcome to the program.", 0, 0.75, 1, 0.25, colors::grey);
+        add_localized_textbox(main_menu_ui, UIState::MAIN_MENU, "Welcome to the program.", TextWrap::none, 0, 0.75, 1,
+                              0.25, colors::grey);
 
         vertex_geometry::Grid grid(4, 1, 0.5, 0.5);
         auto frag_time_rect = grid.get_at(0, 0);
-        main_menu_ui.add_clickable_textbox(on_program_start, on_hover, "RESUME", frag_time_rect, colors::darkgreen,
+        main_menu_ui.add_clickable_textbox(on_program_start, on_hover, localize("RESUME"),
+                                           navigable(UIState::MAIN_MENU, frag_time_rect), colors::darkgreen,
                                            colors::green);
 
         auto settings_rect = grid.get_at(0, 1);
-        main_menu_ui.add_clickable_textbox(on_click_settings, on_hover, "SETTINGS", settings_rect, colors::darkblue,
+        main_menu_ui.add_clickable_textbox(on_click_settings, on_hover, localize("SETTINGS"),
+                                           navigable(UIState::MAIN_MENU, settings_rect), colors::darkblue,
                                            colors::blue);
 
         auto credits_rect = grid.get_at(0, 2);
-        main_menu_ui.add_clickable_textbox(on_click_about, on_hover, "ABOUT", credits_rect, colors::darkblue,
-                                           colors::blue);
+        main_menu_ui.add_clickable_textbox(on_click_about, on_hover, localize("ABOUT"),
+                                           navigable(UIState::MAIN_MENU, credits_rect), colors::darkblue, colors::blue);
 
         auto exit_rect = grid.get_at(0, 3);
-        main_menu_ui.add_clickable_textbox(on_game_quit, on_hover, "QUIT", exit_rect, colors::darkred, colors::red);
+        main_menu_ui.add_clickable_textbox(on_game_quit, on_hover, localize("QUIT"),
+                                           navigable(UIState::MAIN_MENU, exit_rect), colors::darkred, colors::red);
 
         return main_menu_ui;
     }
@@ -250,21 +5462,22 @@ class InputGraphicsSoundMenu {
      *          to return to the main menu.
      */
     UI create_about_ui() {
-        std::function<void()> on_back_clicked = [&]() { curr_state = {UIState::MAIN_MENU}; };
+        std::function<void()> on_back_clicked = [&]() { navigate_back(); };
 
         UI about_ui(0, batcher.absolute_position_with_colored_vertex_shader_batcher.object_id_generator);
         std::function<void(std::string)> on_confirm = [&](std::string contents) { std::cout << contents << std::endl; };
 
-        about_ui.add_textbox(
-            text_utils::add_newlines_to_long_string(
-                "this program was created with the toolbox engine, this engine is an open source collection of tools "
-                "which come together to form an engine to make games using c++, it's designed for programmers and just "
-                "gives you tools to do stuff faster in that realm instead of an all encompassing solution. Learn more "
-                "about it at cpptbx.cuppajoeman.com and join the discord."),
-            0, 0, 1, 1, colors::grey18);
+        add_localized_textbox(
+            about_ui, UIState::ABOUT,
+            "this program was created with the toolbox engine, this engine is an open source collection of tools "
+            "which come together to form an engine to make games using c++, it's designed for programmers and just "
+            "gives you tools to do stuff faster in that realm instead of an all encompassing solution. Learn more "
+            "about it at cpptbx.cuppajoeman.com and join the discord.",
+            TextWrap::long_lines, 0, 0, 1, 1, colors::grey18);
 
-        about_ui.add_clickable_textbox(on_back_clicked, on_hover, "back to main menu", -0.65, -0.65, 0.5, 0.5,
-                                       colors::seagreen, colors::grey);
+        vertex_geometry::Rectangle back_rect(glm::vec3(-0.65, -0.65, 0), 0.5, 0.5);
+        about_ui.add_clickable_textbox(on_back_clicked, on_hover, localize("back to main menu"),
+                                       navigable(UIState::ABOUT, back_rect), colors::seagreen, colors::grey);
 
         return about_ui;
     }
@@ -282,80 +5495,156 @@ class InputGraphicsSoundMenu {
     UI create_settings_menu_ui() {
         UI settings_menu_ui(0, batcher.absolute_position_with_colored_vertex_shader_batcher.object_id_generator);
 
-        vertex_geometry::Grid top_row_grid(1, 5, settings_menu.at(0));
+        std::vector<MenuPanelId> registered_tabs;
+        for (std::size_t i = 0; i < registered_panels.size(); ++i) {
+            if (registered_panels[i]->drawn_over == Menu::index(UIState::SETTINGS_MENU)) {
+                registered_tabs.push_back(Menu::num_states + i);
+            }
+        }
+        // registered panels get a second row of tabs under the built in ones
+        std::vector<vertex_geometry::Rectangle> tab_rows = {settings_menu.at(0)};
+        if (!registered_tabs.empty()) {
+            tab_rows = weighted_subdivision(settings_menu.at(0), {1, 1}, vertex_geometry::CutDirection::horizontal);
+        }
+        vertex_geometry::Grid top_row_grid(1, 5, tab_rows.at(0));
 
         std::function<void()> on_back_clicked = [&]() {
-            sound_system.queue_sound(SoundType::CLICK);
-            curr_state = UIState::MAIN_MENU;
+            play_ui_sound(SoundType::CLICK);
+            navigate_back();
         };
         std::function<void()> on_apply_clicked = [&]() {
-            sound_system.queue_sound(SoundType::CLICK);
+            play_ui_sound(SoundType::CLICK);
             configuration.apply_config_logic();
         };
         std::function<void()> on_save_clicked = [&]() {
-            sound_system.queue_sound(SoundType::CLICK);
-            configuration.save_to_file();
+            play_ui_sound(SoundType::CLICK);
+            save_config_to_file();
         };
-        std::function<void()> settings_on_click = [&]() { sound_system.queue_sound(SoundType::CLICK); };
+        std::function<void()> settings_on_click = [&]() { play_ui_sound(SoundType::CLICK); };
 
         std::function<void()> player_on_click = [&]() {
-            sound_system.queue_sound(SoundType::CLICK);
-            curr_state = UIState::PROGRAM_SETTINGS;
+            play_ui_sound(SoundType::CLICK);
+            transition<UIState::SETTINGS_MENU, UIState::PROGRAM_SETTINGS>();
         };
         auto player_rect = top_row_grid.get_at(0, 0);
-        settings_menu_ui.add_clickable_textbox(player_on_click, on_hover, "player", player_rect, colors::darkblue,
+        settings_menu_ui.add_clickable_textbox(player_on_click, on_hover, localize("player"),
+                                               navigable(UIState::SETTINGS_MENU, player_rect), colors::darkblue,
                                                colors::blue);
 
         std::function<void()> input_on_click = [&]() {
-            sound_system.queue_sound(SoundType::CLICK);
-            curr_state = UIState::INPUT_SETTINGS;
+            play_ui_sound(SoundType::CLICK);
+            transition<UIState::SETTINGS_MENU, UIState::INPUT_SETTINGS>();
         };
         auto input_rect = top_row_grid.get_at(1, 0);
-        settings_menu_ui.add_clickable_textbox(input_on_click, on_hover, "input", input_rect, colors::darkblue,
+        settings_menu_ui.add_clickable_textbox(input_on_click, on_hover, localize("input"),
+                                               navigable(UIState::SETTINGS_MENU, input_rect), colors::darkblue,
                                                colors::blue);
 
         std::function<void()> sound_on_click = [&]() {
-            sound_system.queue_sound(SoundType::CLICK);
-            curr_state = UIState::SOUND_SETTINGS;
+            play_ui_sound(SoundType::CLICK);
+            transition<UIState::SETTINGS_MENU, UIState::SOUND_SETTINGS>();
         };
         auto sound_rect = top_row_grid.get_at(2, 0);
-        settings_menu_ui.add_clickable_textbox(sound_on_click, on_hover, "sound", sound_rect, colors::darkblue,
+        settings_menu_ui.add_clickable_textbox(sound_on_click, on_hover, localize("sound"),
+                                               navigable(UIState::SETTINGS_MENU, sound_rect), colors::darkblue,
                                                colors::blue);
 
         std::function<void()> graphics_on_click = [&]() {
-            sound_system.queue_sound(SoundType::CLICK);
-            curr_state = UIState::GRAPHICS_SETTINGS;
+            play_ui_sound(SoundType::CLICK);
+            transition<UIState::SETTINGS_MENU, UIState::GRAPHICS_SETTINGS>();
         };
         auto graphics_rect = top_row_grid.get_at(3, 0);
-        settings_menu_ui.add_clickable_textbox(graphics_on_click, on_hover, "graphics", graphics_rect, colors::darkblue,
+        settings_menu_ui.add_clickable_textbox(graphics_on_click, on_hover, localize("graphics"),
+                                               navigable(UIState::SETTINGS_MENU, graphics_rect), colors::darkblue,
                                                colors::blue);
 
         std::function<void()> network_on_click = [&]() {
-            sound_system.queue_sound(SoundType::CLICK);
-            curr_state = UIState::ADVANCED_SETTINGS;
+            play_ui_sound(SoundType::CLICK);
+            transition<UIState::SETTINGS_MENU, UIState::ADVANCED_SETTINGS>();
         };
         auto network_rect = top_row_grid.get_at(4, 0);
-        settings_menu_ui.add_clickable_textbox(network_on_click, on_hover, "network", network_rect, colors::darkblue,
+        settings_menu_ui.add_clickable_textbox(network_on_click, on_hover, localize("network"),
+                                               navigable(UIState::SETTINGS_MENU, network_rect), colors::darkblue,
                                                colors::blue);
 
+        if (!registered_tabs.empty()) {
+            vertex_geometry::Grid registered_tab_grid(1, std::max<int>(5, registered_tabs.size()), tab_rows.at(1));
+            for (std::size_t i = 0; i < registered_tabs.size(); ++i) {
+                MenuPanelId panel = registered_tabs[i];
+                std::function<void()> tab_on_click = [this, panel]() {
+                    play_ui_sound(SoundType::CLICK);
+                    navigate(Menu::index(UIState::SETTINGS_MENU), panel);
+                };
+                settings_menu_ui.add_clickable_textbox(
+                    tab_on_click, on_hover, registered_panels[panel - Menu::num_states]->tab_label,
+                    navigable(UIState::SETTINGS_MENU, registered_tab_grid.get_at(i, 0)), colors::darkblue,
+                    colors::blue);
+            }
+        }
+
         vertex_geometry::Rectangle main_settings_rect = settings_menu.at(1);
         settings_menu_ui.add_colored_rectangle(main_settings_rect, colors::grey);
 
         vertex_geometry::Rectangle go_back_rect = vertex_geometry::create_rectangle_from_corners(
             glm::vec3(-1, -0.75, 0), glm::vec3(-0.75, -0.75, 0), glm::vec3(-1, -1, 0), glm::vec3(-0.75, -1, 0));
-        settings_menu_ui.add_clickable_textbox(on_back_clicked, on_hover, "BACK", go_back_rect, colors::darkred,
+        settings_menu_ui.add_clickable_textbox(on_back_clicked, on_hover, localize("BACK"),
+                                               navigable(UIState::SETTINGS_MENU, go_back_rect), colors::darkred,
                                                colors::red);
 
         vertex_geometry::Rectangle apply_rect = vertex_geometry::create_rectangle_from_corners(
             glm::vec3(1, -0.75, 0), glm::vec3(0.75, -0.75, 0), glm::vec3(1, -1, 0), glm::vec3(0.75, -1, 0));
-        settings_menu_ui.add_clickable_textbox(on_apply_clicked, on_hover, "APPLY", apply_rect, colors::darkgreen,
+        settings_menu_ui.add_clickable_textbox(on_apply_clicked, on_hover, localize("APPLY"),
+                                               navigable(UIState::SETTINGS_MENU, apply_rect), colors::darkgreen,
                                                colors::green);
 
         vertex_geometry::Rectangle save_rect = vertex_geometry::slide_rectangle(apply_rect, -1, 0);
 
-        settings_menu_ui.add_clickable_textbox(on_save_clicked, on_hover, "SAVE", save_rect, colors::darkgreen,
+        settings_menu_ui.add_clickable_textbox(on_save_clicked, on_hover, localize("SAVE"),
+                                               navigable(UIState::SETTINGS_MENU, save_rect), colors::darkgreen,
                                                colors::green);
 
+        std::function<void()> on_undo_clicked = [&]() {
+            play_ui_sound(SoundType::CLICK);
+            undo_requested = true;
+        };
+        std::function<void()> on_redo_clicked = [&]() {
+            play_ui_sound(SoundType::CLICK);
+            redo_requested = true;
+        };
+        vertex_geometry::Rectangle redo_rect = vertex_geometry::slide_rectangle(save_rect, -1, 0);
+        settings_menu_ui.add_clickable_textbox(on_redo_clicked, on_hover, localize("REDO"),
+                                               navigable(UIState::SETTINGS_MENU, redo_rect), colors::darkblue,
+                                               colors::blue);
+        vertex_geometry::Rectangle undo_rect = vertex_geometry::slide_rectangle(redo_rect, -1, 0);
+        settings_menu_ui.add_clickable_textbox(on_undo_clicked, on_hover, localize("UNDO"),
+                                               navigable(UIState::SETTINGS_MENU, undo_rect), colors::darkblue,
+                                               colors::blue);
+
+        std::vector<std::string> profile_options = {SettingsProfiles::base_config_name};
+        for (const auto &name : settings_profiles.get_profile_names()) {
+            profile_options.push_back(name);
+        }
+        std::function<void(std::string)> profile_on_click = [this](std::string option) {
+            play_ui_sound(SoundType::CLICK);
+            pending_settings_profile = option == SettingsProfiles::base_config_name ? "" : option;
+        };
+        const std::string &active_profile = settings_profiles.get_active_profile();
+        int profile_option_idx = get_index_or_default(
+            active_profile.empty() ? SettingsProfiles::base_config_name : active_profile, profile_options);
+        vertex_geometry::Rectangle profile_rect = vertex_geometry::slide_rectangle(go_back_rect, 1, 0);
+
+        std::function<void()> on_search_clicked = [&]() {
+            play_ui_sound(SoundType::CLICK);
+            open_settings_search();
+        };
+        settings_menu_ui.add_clickable_textbox(
+            on_search_clicked, on_hover, localize("search"),
+            navigable(UIState::SETTINGS_MENU, vertex_geometry::slide_rectangle(profile_rect, 1, 0)), colors::darkblue,
+            colors::blue);
+        add_navigable_dropdown(settings_menu_ui, UIState::SETTINGS_MENU, "profile", settings_on_click, on_hover,
+                               profile_option_idx, profile_rect, colors::darkblue, colors::blue, profile_options,
+                               profile_on_click, dropdown_on_hover);
+
         vertex_geometry::Grid main_settings_grid(7, 3, main_settings_rect);
 
         return settings_menu_ui;
@@ -379,10 +5668,13 @@ class InputGraphicsSoundMenu {
         vertex_geometry::Grid main_settings_grid(7, 3, main_settings_rect);
 
         std::function<void(std::string)> username_on_confirm = [](std::string s) {};
-        player_settings_ui.add_textbox("username", main_settings_grid.get_at(0, 0), colors::maroon);
-        player_settings_ui.add_input_box(on_confirm, "username", main_settings_grid.get_at(2, 0), colors::orange,
-                                         colors::orangered);
-        player_settings_ui.add_textbox("crosshair", main_settings_grid.get_at(0, 1), colors::maroon);
+        add_searchable_label(player_settings_ui, UIState::PROGRAM_SETTINGS, "username",
+                             main_settings_grid.get_at(0, 0));
+        player_settings_ui.add_input_box(on_confirm, "username",
+                                         navigable(UIState::PROGRAM_SETTINGS, main_settings_grid.get_at(2, 0)),
+                                         colors::orange, colors::orangered);
+        add_searchable_label(player_settings_ui, UIState::PROGRAM_SETTINGS, "crosshair",
+                             main_settings_grid.get_at(0, 1));
 
         vertex_geometry::Grid input_settings_grid(10, 3, main_settings_rect);
 
@@ -394,85 +5686,120 @@ class InputGraphicsSoundMenu {
      *
      * @return A fully constructed UI object for input configuration.
      *
-     * @details Provides editable input bindings for key actions (forward, back, left, right, etc.)
-     *          and configurable mouse sensitivity.
-     *
-     * @warning Uses `InputState::is_valid_key_string` for validation — this dependency should be removed in future.
+     * @details Shows the chords bound to each action (forward, back, left, right, etc.), "set" replaces them with the
+     *          next chord pressed and "add" adds it as another binding. Also allows configuring mouse sensitivity.
      */
     UI create_input_settings_ui() {
 
         vertex_geometry::Rectangle main_settings_rect = settings_menu.at(1);
         vertex_geometry::Grid main_settings_grid(7, 3, main_settings_rect);
 
-        vertex_geometry::Grid input_settings_grid(11, 3, main_settings_rect);
+        vertex_geometry::Grid input_settings_grid(11, 4, main_settings_rect);
         UI input_settings_ui(-0.1, batcher.absolute_position_with_colored_vertex_shader_batcher.object_id_generator);
-        input_settings_ui.add_textbox("mouse sensitivity", input_settings_grid.get_at(0, 0), colors::maroon);
+        add_searchable_label(input_settings_ui, UIState::INPUT_SETTINGS, "mouse sensitivity",
+                             input_settings_grid.get_at(0, 0));
 
         std::function<void(std::string)> sens_on_click = [this](std::string option) {
-            sound_system.queue_sound(SoundType::CLICK);
-            configuration.set_value("input", "mouse_sensitivity", option);
+            play_ui_sound(SoundType::CLICK);
+            set_config_value("input", "mouse_sensitivity", option);
         };
 
-        input_settings_ui.add_input_box(sens_on_click, "1", input_settings_grid.get_at(2, 0), colors::grey,
-                                        colors::lightgrey);
+        input_settings_ui.add_input_box(sens_on_click, get_config_value("input", "mouse_sensitivity").value_or("1"),
+                                        navigable(UIState::INPUT_SETTINGS, input_settings_grid.get_at(2, 0)),
+                                        colors::grey, colors::lightgrey);
 
-        std::function<void(std::string)> on_confirm = [&](std::string contents) { std::cout << contents << std::endl; };
+        std::function<void()> curve_on_click = [this]() {
+            play_ui_sound(SoundType::CLICK);
+            transition<UIState::INPUT_SETTINGS, UIState::MOUSE_SETTINGS>();
+        };
+        input_settings_ui.add_clickable_textbox(curve_on_click, on_hover, localize("curve"),
+                                                navigable(UIState::INPUT_SETTINGS, input_settings_grid.get_at(3, 0)),
+                                                colors::darkblue, colors::blue);
 
-        input_settings_ui.add_textbox("fire", input_settings_grid.get_at(0, 1), colors::maroon);
-        input_settings_ui.add_input_box(on_confirm, "lmb", input_settings_grid.get_at(2, 1), colors::grey,
-                                        colors::lightgrey);
-
-        input_settings_ui.add_textbox("jump", input_settings_grid.get_at(0, 2), colors::maroon);
-        input_settings_ui.add_input_box(on_confirm, "space", input_settings_grid.get_at(2, 2), colors::grey,
-                                        colors::lightgrey);
-
-        std::function<std::function<void(std::string)>(std::string)> create_key_on_confirm_function =
-            [&](std::string key_str) {
-                return [this, key_str](std::string input_value) {
-                    if (input_state.is_valid_key_string(input_value)) {
-                        configuration.set_value("input", key_str, input_value);
-                        sound_system.queue_sound(SoundType::CLICK);
-                    } else {
-                        logger.warn("{} is not a valid key string, not setting it in the config, use a proper value.",
-                                    input_value);
-                    }
+        for (size_t i = 0; i < input_binding_settings.size(); i++) {
+            const InputBindingSetting &binding = input_binding_settings[i];
+            int row = static_cast<int>(i) + 1;
+
+            auto create_capture_on_click = [this, action = binding.action](bool adds_binding) {
+                return [this, action, adds_binding]() {
+                    play_ui_sound(SoundType::CLICK);
+                    capturing_action = action;
+                    capture_adds_binding = adds_binding;
+                    captured_modifier.reset();
+                    push_key_capture_prompt(input_binding_settings[static_cast<std::size_t>(action)].label);
                 };
             };
 
-        input_settings_ui.add_textbox("move forward", input_settings_grid.get_at(0, 3), colors::maroon);
-        input_settings_ui.add_input_box(create_key_on_confirm_function("forward"),
-                                        configuration.get_value("input", "forward").value_or("w"),
-                                        input_settings_grid.get_at(2, 3), colors::grey, colors::lightgrey);
-
-        input_settings_ui.add_textbox("move backward", input_settings_grid.get_at(0, 4), colors::maroon);
-        input_settings_ui.add_input_box(create_key_on_confirm_function("back"), "s", input_settings_grid.get_at(2, 4),
-                                        colors::grey, colors::lightgrey);
+            add_searchable_label(input_settings_ui, UIState::INPUT_SETTINGS, binding.label,
+                                 input_settings_grid.get_at(0, row));
+            binding_textbox_ids[static_cast<std::size_t>(binding.action)] = input_settings_ui.add_textbox(
+                get_config_value("input", binding.config_key).value_or(binding.default_key),
+                input_settings_grid.get_at(1, row), colors::grey);
+            input_settings_ui.add_clickable_textbox(
+                create_capture_on_click(false), on_hover, localize("set"),
+                navigable(UIState::INPUT_SETTINGS, input_settings_grid.get_at(2, row)), colors::darkblue, colors::blue);
+            input_settings_ui.add_clickable_textbox(
+                create_capture_on_click(true), on_hover, localize("add"),
+                navigable(UIState::INPUT_SETTINGS, input_settings_grid.get_at(3, row)), colors::darkblue, colors::blue);
+        }
 
-        input_settings_ui.add_textbox("move left", input_settings_grid.get_at(0, 5), colors::maroon);
-        input_settings_ui.add_input_box(create_key_on_confirm_function("left"), "a", input_settings_grid.get_at(2, 5),
-                                        colors::grey, colors::lightgrey);
+        return input_settings_ui;
+    }
 
-        input_settings_ui.add_textbox("move right", input_settings_grid.get_at(0, 6), colors::maroon);
-        input_settings_ui.add_input_box(create_key_on_confirm_function("right"), "d", input_settings_grid.get_at(2, 6),
-                                        colors::grey, colors::lightgrey);
+    /**
+     * @brief Creates and returns the Mouse Settings UI.
+     *
+     * @return A fully constructed UI object for the mouse sensitivity curve.
+     *
+     * @details Lets you pick a linear, power or custom curve and scale the x and y axes separately, every change
+     *          recompiles MouseSensitivityCurve through the config handlers.
+     */
+    UI create_mouse_settings_ui() {
+        vertex_geometry::Rectangle main_settings_rect = settings_menu.at(1);
+        vertex_geometry::Grid mouse_settings_grid(6, 3, main_settings_rect);
+        UI mouse_settings_ui(-0.1, batcher.absolute_position_with_colored_vertex_shader_batcher.object_id_generator);
 
-        input_settings_ui.add_textbox("move up", input_settings_grid.get_at(0, 7), colors::maroon);
-        input_settings_ui.add_input_box(create_key_on_confirm_function("left"), " ", input_settings_grid.get_at(2, 7),
-                                        colors::grey, colors::lightgrey);
+        std::function<void()> on_click_settings = [&]() {};
+        auto create_on_confirm = [this](std::string key) {
+            return [this, key](std::string value) {
+                play_ui_sound(SoundType::CLICK);
+                set_config_value("input", key, value);
+            };
+        };
 
-        input_settings_ui.add_textbox("move down", input_settings_grid.get_at(0, 8), colors::maroon);
-        input_settings_ui.add_input_box(create_key_on_confirm_function("down"), "left_shift",
-                                        input_settings_grid.get_at(2, 8), colors::grey, colors::lightgrey);
+        std::vector<std::string> curve_options = {"linear", "power", "custom"};
+        int dropdown_option_idx =
+            get_index_or_default(get_config_value("input", "mouse_curve").value_or("linear"), curve_options);
+        add_searchable_label(mouse_settings_ui, UIState::MOUSE_SETTINGS, "curve", mouse_settings_grid.get_at(0, 0));
+        add_navigable_dropdown(mouse_settings_ui, UIState::MOUSE_SETTINGS, "curve", on_click_settings, on_hover,
+                               dropdown_option_idx, mouse_settings_grid.get_at(2, 0), colors::orange, colors::orangered,
+                               curve_options, create_on_confirm("mouse_curve"), dropdown_on_hover);
 
-        input_settings_ui.add_textbox("slow move", input_settings_grid.get_at(0, 9), colors::maroon);
-        input_settings_ui.add_input_box(create_key_on_confirm_function("slow_move"), "left_control",
-                                        input_settings_grid.get_at(2, 9), colors::grey, colors::lightgrey);
+        std::vector<std::tuple<std::string, std::string, std::string>> input_box_settings = {
+            {"power exponent", "mouse_curve_exponent", "1"},
+            {"custom curve (speed:gain, ...)", "mouse_curve_points", "0:1, 60:2"},
+            {"x scale", "mouse_x_scale", "1"},
+            {"y scale", "mouse_y_scale", "1"},
+        };
+        for (size_t i = 0; i < input_box_settings.size(); i++) {
+            const auto &[label, key, default_value] = input_box_settings[i];
+            int row = static_cast<int>(i) + 1;
+            add_searchable_label(mouse_settings_ui, UIState::MOUSE_SETTINGS, label, mouse_settings_grid.get_at(0, row));
+            mouse_settings_ui.add_input_box(create_on_confirm(key),
+                                            get_config_value("input", key).value_or(default_value),
+                                            navigable(UIState::MOUSE_SETTINGS, mouse_settings_grid.get_at(2, row)),
+                                            colors::grey, colors::lightgrey);
+        }
 
-        input_settings_ui.add_textbox("fast move", input_settings_grid.get_at(0, 10), colors::maroon);
-        input_settings_ui.add_input_box(create_key_on_confirm_function("fast_move"), "tab",
-                                        input_settings_grid.get_at(2, 10), colors::grey, colors::lightgrey);
+        std::function<void()> back_on_click = [this]() {
+            play_ui_sound(SoundType::CLICK);
+            navigate_back();
+        };
+        mouse_settings_ui.add_clickable_textbox(back_on_click, on_hover, localize("back to input"),
+                                                navigable(UIState::MOUSE_SETTINGS, mouse_settings_grid.get_at(2, 5)),
+                                                colors::darkblue, colors::blue);
 
-        return input_settings_ui;
+        return mouse_settings_ui;
     }
 
     /**
@@ -480,17 +5807,89 @@ class InputGraphicsSoundMenu {
      *
      * @return A fully constructed UI object for sound settings.
      *
-     * @details Currently only provides a volume control placeholder.
-     * @todo Implement actual volume adjustment integration with SoundSystem.
+     * @details Provides a volume control for the master, ui, music and effects buses, these are stored in the
+     *          "sound" section of the config and applied to the SoundBusMixer by the config handlers. Also lets you
+     *          pick the output device, sample rate and buffer size and shows the resulting underruns and latency.
      */
     UI create_sound_settings_ui() {
 
         vertex_geometry::Rectangle main_settings_rect = settings_menu.at(1);
         vertex_geometry::Grid main_settings_grid(7, 3, main_settings_rect);
 
-        vertex_geometry::Grid sound_settings_grid(1, 3, main_settings_rect);
+        vertex_geometry::Grid sound_settings_grid(9, 3, main_settings_rect);
         UI sound_settings_ui(-0.1, batcher.absolute_position_with_colored_vertex_shader_batcher.object_id_generator);
-        sound_settings_ui.add_textbox("volume", sound_settings_grid.get_at(0, 0), colors::maroon);
+
+        std::function<void()> on_click_settings = [&]() {};
+
+        std::vector<std::string> volume_labels = {"master volume", "ui volume", "music volume", "effects volume"};
+        for (size_t i = 0; i < sound_bus_config_keys.size(); i++) {
+            const auto &[bus, key] = sound_bus_config_keys[i];
+            add_searchable_label(sound_settings_ui, UIState::SOUND_SETTINGS, volume_labels[i],
+                                 sound_settings_grid.get_at(0, i));
+            add_slider(sound_settings_ui, UIState::SOUND_SETTINGS, volume_labels[i], "sound", key, 0, 100, 10,
+                       sound_settings_grid.get_at(1, i), sound_settings_grid.get_at(2, i),
+                       [this, bus = bus] { return sound_bus_mixer.get_bus_gain(bus) * 100; },
+                       [](float percentage) { return fmt::format("{:.0f}%", percentage); });
+        }
+
+        std::vector<std::string> device_options;
+        for (const auto &device : audio_device_cache.get_devices()) {
+            device_options.push_back(device.name);
+        }
+        if (device_options.empty()) {
+            device_options = {"default"};
+        }
+
+        // the sample rates the chosen device reports, the common ones if it doesn't report any
+        std::string selected_device = get_config_value("sound", "output_device").value_or(device_options.front());
+        std::vector<std::string> sample_rate_options;
+        for (const auto &device : audio_device_cache.get_devices()) {
+            if (device.name == selected_device) {
+                for (unsigned int sample_rate : device.supported_sample_rates) {
+                    sample_rate_options.push_back(std::to_string(sample_rate));
+                }
+            }
+        }
+        if (sample_rate_options.empty()) {
+            sample_rate_options = {"44100", "48000", "96000"};
+        }
+        std::vector<std::string> buffer_frames_options = {"64", "128", "256", "512", "1024", "2048"};
+
+        std::vector<std::tuple<std::string, std::string, std::vector<std::string> *, std::string>> output_settings = {
+            {"output device", "output_device", &device_options, device_options.front()},
+            {"sample rate", "sample_rate", &sample_rate_options, sample_rate_options.front()},
+            {"buffer frames", "buffer_frames", &buffer_frames_options, "512"},
+        };
+
+        for (size_t i = 0; i < output_settings.size(); i++) {
+            const auto &[label, key, options, default_value] = output_settings[i];
+            int row = static_cast<int>(sound_bus_config_keys.size() + i);
+
+            std::function<void(std::string)> output_on_click = [this, key = key](std::string option) {
+                play_ui_sound(SoundType::CLICK);
+                set_config_value("sound", key, option);
+                // another device supports other sample rates, the dropdown is refilled at the start of the next frame
+                sound_settings_ui_stale = sound_settings_ui_stale || key == "output_device";
+            };
+
+            int dropdown_option_idx =
+                get_index_or_default(get_config_value("sound", key).value_or(default_value), *options);
+            add_searchable_label(sound_settings_ui, UIState::SOUND_SETTINGS, label, sound_settings_grid.get_at(0, row));
+            add_navigable_dropdown(sound_settings_ui, UIState::SOUND_SETTINGS, label, on_click_settings, on_hover,
+                                   dropdown_option_idx, sound_settings_grid.get_at(2, row), colors::orange,
+                                   colors::orangered, *options, output_on_click, dropdown_on_hover);
+        }
+
+        add_searchable_label(sound_settings_ui, UIState::SOUND_SETTINGS, "underruns", sound_settings_grid.get_at(0, 7));
+        underrun_textbox_id = sound_settings_ui.add_textbox(std::to_string(displayed_underrun_count),
+                                                            sound_settings_grid.get_at(2, 7), colors::grey);
+
+        add_searchable_label(sound_settings_ui, UIState::SOUND_SETTINGS, "output latency",
+                             sound_settings_grid.get_at(0, 8));
+        displayed_output_latency_ms = -1; // so the new textbox is filled in on the next update
+        output_latency_textbox_id =
+            sound_settings_ui.add_textbox(localize("unknown"), sound_settings_grid.get_at(2, 8), colors::grey);
+
         return sound_settings_ui;
     }
 
@@ -505,7 +5904,8 @@ class InputGraphicsSoundMenu {
      * @return A fully constructed UI object for graphics settings.
      *
      * @details Includes controls for resolution, fullscreen, wireframe mode, FOV, FPS cap,
-     *          and options to toggle FPS and position display.
+     *          options to toggle FPS and position display, a quality preset, the render scale, vsync and low latency
+     *          mode.
      *
      * @warning On macOS, available resolution detection may fail; a fallback resolution ("1920x1080") is used.
      * @todo Add dropdown validation for resolution parsing and better error feedback.
@@ -523,25 +5923,30 @@ class InputGraphicsSoundMenu {
         if (resolutions.empty())
             resolutions = {"1920x1080"};
 
+        resolution_options = resolutions;
+        std::stable_sort(resolution_options.begin(), resolution_options.end(),
+                         [](const std::string &a, const std::string &b) {
+                             auto a_dimensions = parse_resolution(a).value_or(std::make_pair(0u, 0u));
+                             auto b_dimensions = parse_resolution(b).value_or(std::make_pair(0u, 0u));
+                             return a_dimensions.first * a_dimensions.second < b_dimensions.first * b_dimensions.second;
+                         });
+
         std::function<void(std::string)> on_confirm = [&](std::string contents) { std::cout << contents << std::endl; };
 
         vertex_geometry::Rectangle main_settings_rect = settings_menu.at(1);
         vertex_geometry::Grid main_settings_grid(7, 3, main_settings_rect);
 
-        std::function<void()> on_click_settings = [&]() { curr_state = UIState::PROGRAM_SETTINGS; };
+        std::function<void()> on_click_settings = [&]() {};
 
         std::vector<std::string> on_off_options = {"on", "off"};
 
-        vertex_geometry::Grid graphics_settings_grid(10, 3, main_settings_rect);
+        vertex_geometry::Grid graphics_settings_grid(11, 3, main_settings_rect);
         UI graphics_settings_ui(-0.1, batcher.absolute_position_with_colored_vertex_shader_batcher.object_id_generator);
 
-        std::vector<std::string> options = resolutions;
-        std::vector<std::function<void()>> option_on_clicks(options.size(), []() {});
-
         std::function<void(std::string)> empty_on_click = [](std::string option) { std::cout << option << std::endl; };
 
         std::function<void(std::string)> resolution_dropdown_on_click = [this](std::string option) {
-            sound_system.queue_sound(SoundType::CLICK);
+            play_ui_sound(SoundType::CLICK);
             size_t x_pos = option.find('x');
             unsigned int width, height;
             if (x_pos != std::string::npos) {
@@ -549,7 +5954,9 @@ class InputGraphicsSoundMenu {
                 height = std::stoi(option.substr(x_pos + 1));
                 // the above verifies that indeed the things are numbers which means its valid I think... probably not
                 // needed since the options are already
-                configuration.set_value("graphics", "resolution", option);
+                set_config_value("graphics", "resolution", option);
+                // picking a resolution by hand means no preset is in use anymore
+                set_config_value("graphics", "quality_preset", "custom");
             } else {
                 throw std::invalid_argument("Input string is not in the correct format (e.g. 1280x960)");
             }
@@ -557,73 +5964,141 @@ class InputGraphicsSoundMenu {
 
         int dropdown_option_idx;
 
-        dropdown_option_idx =
-            get_index_or_default(configuration.get_value("graphics", "resolution").value_or("1280x720"), options);
-        graphics_settings_ui.add_textbox("resolution", graphics_settings_grid.get_at(0, 0), colors::maroon);
-
-        graphics_settings_ui.add_dropdown(on_click_settings, on_hover, dropdown_option_idx,
-                                          graphics_settings_grid.get_at(2, 0), colors::orange, colors::orangered,
-                                          options, resolution_dropdown_on_click, dropdown_on_hover);
+        // the resolutions are picked from a virtualized list popup since a monitor can report a lot of them
+        std::string current_resolution = get_config_value("graphics", "resolution").value_or("1280x720");
+        std::function<void()> resolution_on_click = [this, current_resolution, resolution_dropdown_on_click]() {
+            play_ui_sound(SoundType::CLICK);
+            std::size_t selected_idx = get_index_or_default(current_resolution, resolution_options);
+            push_list_popup(localize("resolution"), resolution_options, selected_idx,
+                            [this, resolution_dropdown_on_click](std::size_t idx) {
+                                resolution_dropdown_on_click(resolution_options[idx]);
+                                rebuild_ui(UIState::GRAPHICS_SETTINGS);
+                            });
+        };
+        add_searchable_label(graphics_settings_ui, UIState::GRAPHICS_SETTINGS, "resolution",
+                             graphics_settings_grid.get_at(0, 0));
+        graphics_settings_ui.add_clickable_textbox(
+            resolution_on_click, on_hover, current_resolution,
+            navigable(UIState::GRAPHICS_SETTINGS, graphics_settings_grid.get_at(2, 0)), colors::orange,
+            colors::orangered);
 
         std::function<void(std::string)> fullscreen_on_click = [this](std::string option) {
-            sound_system.queue_sound(SoundType::CLICK);
-            configuration.set_value("graphics", "fullscreen", option);
+            play_ui_sound(SoundType::CLICK);
+            set_config_value("graphics", "fullscreen", option);
         };
 
         dropdown_option_idx =
-            get_index_or_default(configuration.get_value("graphics", "fullscreen").value_or("off"), on_off_options);
-        graphics_settings_ui.add_textbox("fullscreen", graphics_settings_grid.get_at(0, 1), colors::maroon);
-        graphics_settings_ui.add_dropdown(on_click_settings, on_hover, dropdown_option_idx,
-                                          graphics_settings_grid.get_at(2, 1), colors::orange, colors::orangered,
-                                          on_off_options, fullscreen_on_click, dropdown_on_hover);
+            get_index_or_default(get_config_value("graphics", "fullscreen").value_or("off"), on_off_options);
+        add_searchable_label(graphics_settings_ui, UIState::GRAPHICS_SETTINGS, "fullscreen",
+                             graphics_settings_grid.get_at(0, 1));
+        add_navigable_dropdown(graphics_settings_ui, UIState::GRAPHICS_SETTINGS, "fullscreen", on_click_settings,
+                               on_hover, dropdown_option_idx, graphics_settings_grid.get_at(2, 1), colors::orange,
+                               colors::orangered, on_off_options, fullscreen_on_click, dropdown_on_hover);
 
         std::function<void(std::string)> wireframe_on_click = [this](std::string option) {
-            sound_system.queue_sound(SoundType::CLICK);
-            configuration.set_value("graphics", "wireframe", option);
+            play_ui_sound(SoundType::CLICK);
+            set_config_value("graphics", "wireframe", option);
         };
 
         dropdown_option_idx =
-            get_index_or_default(configuration.get_value("graphics", "wireframe").value_or("off"), on_off_options);
-        graphics_settings_ui.add_textbox("wireframe", graphics_settings_grid.get_at(0, 2), colors::maroon);
-        graphics_settings_ui.add_dropdown(on_click_settings, on_hover, dropdown_option_idx,
-                                          graphics_settings_grid.get_at(2, 2), colors::orange, colors::orangered,
-                                          on_off_options, wireframe_on_click, dropdown_on_hover);
-
-        std::function<void(std::string)> fov_on_confirm = [&](std::string option) {
-            configuration.set_value("graphics", "field_of_view", option);
-        };
+            get_index_or_default(get_config_value("graphics", "wireframe").value_or("off"), on_off_options);
+        add_searchable_label(graphics_settings_ui, UIState::GRAPHICS_SETTINGS, "wireframe",
+                             graphics_settings_grid.get_at(0, 2));
+        add_navigable_dropdown(graphics_settings_ui, UIState::GRAPHICS_SETTINGS, "wireframe", on_click_settings,
+                               on_hover, dropdown_option_idx, graphics_settings_grid.get_at(2, 2), colors::orange,
+                               colors::orangered, on_off_options, wireframe_on_click, dropdown_on_hover);
 
-        graphics_settings_ui.add_textbox("field of view", graphics_settings_grid.get_at(0, 3), colors::maroon);
-        graphics_settings_ui.add_input_box(
-            fov_on_confirm, configuration.get_value("graphics", "field_of_view").value_or("degrees (30-160 limit)"),
-            graphics_settings_grid.get_at(2, 3), colors::grey, colors::lightgrey);
+        add_searchable_label(graphics_settings_ui, UIState::GRAPHICS_SETTINGS, "field of view",
+                             graphics_settings_grid.get_at(0, 3));
+        add_slider(graphics_settings_ui, UIState::GRAPHICS_SETTINGS, "field of view", "graphics", "field_of_view",
+                   min_field_of_view_degrees, max_field_of_view_degrees, 10, graphics_settings_grid.get_at(1, 3),
+                   graphics_settings_grid.get_at(2, 3), [this] { return field_of_view_degrees; }, format_field_of_view);
 
         std::function<void(std::string)> max_fps_on_confirm = [&](std::string option) {
-            configuration.set_value("graphics", "max_fps", option);
+            set_config_value("graphics", "max_fps", option);
+            update_frame_time_targets();
         };
 
-        graphics_settings_ui.add_textbox("max fps", graphics_settings_grid.get_at(0, 4), colors::maroon);
-        graphics_settings_ui.add_input_box(max_fps_on_confirm,
-                                           configuration.get_value("graphics", "max_fps").value_or("60"),
-                                           graphics_settings_grid.get_at(2, 4), colors::grey, colors::lightgrey);
+        add_searchable_label(graphics_settings_ui, UIState::GRAPHICS_SETTINGS, "max fps",
+                             graphics_settings_grid.get_at(0, 4));
+        graphics_settings_ui.add_input_box(max_fps_on_confirm, get_config_value("graphics", "max_fps").value_or("60"),
+                                           navigable(UIState::GRAPHICS_SETTINGS, graphics_settings_grid.get_at(2, 4)),
+                                           colors::grey, colors::lightgrey);
 
         std::function<void(std::string)> show_fps_on_click = [&](std::string option) {
-            configuration.set_value("graphics", "show_fps", option);
+            set_config_value("graphics", "show_fps", option);
         };
 
-        graphics_settings_ui.add_textbox("show fps", graphics_settings_grid.get_at(0, 5), colors::maroon);
-        graphics_settings_ui.add_dropdown(on_click_settings, on_hover, dropdown_option_idx,
-                                          graphics_settings_grid.get_at(2, 5), colors::orange, colors::orangered,
-                                          on_off_options, show_fps_on_click, dropdown_on_hover);
+        add_searchable_label(graphics_settings_ui, UIState::GRAPHICS_SETTINGS, "show fps",
+                             graphics_settings_grid.get_at(0, 5));
+        add_navigable_dropdown(graphics_settings_ui, UIState::GRAPHICS_SETTINGS, "show fps", on_click_settings,
+                               on_hover, dropdown_option_idx, graphics_settings_grid.get_at(2, 5), colors::orange,
+                               colors::orangered, on_off_options, show_fps_on_click, dropdown_on_hover);
 
         std::function<void(std::string)> show_pos_on_click = [&](std::string option) {
-            configuration.set_value("graphics", "show_pos", option);
+            set_config_value("graphics", "show_pos", option);
+        };
+
+        add_searchable_label(graphics_settings_ui, UIState::GRAPHICS_SETTINGS, "show pos",
+                             graphics_settings_grid.get_at(0, 6));
+        add_navigable_dropdown(graphics_settings_ui, UIState::GRAPHICS_SETTINGS, "show pos", on_click_settings,
+                               on_hover, dropdown_option_idx, graphics_settings_grid.get_at(2, 6), colors::orange,
+                               colors::orangered, on_off_options, show_pos_on_click, dropdown_on_hover);
+
+        std::function<void(std::string)> quality_preset_on_click = [this](std::string option) {
+            play_ui_sound(SoundType::CLICK);
+            set_config_value("graphics", "quality_preset", option);
+        };
+
+        std::vector<std::string> quality_preset_options = {"custom", "low", "medium", "high", "auto"};
+        dropdown_option_idx = get_index_or_default(
+            get_config_value("graphics", "quality_preset").value_or("custom"), quality_preset_options);
+        add_searchable_label(graphics_settings_ui, UIState::GRAPHICS_SETTINGS, "quality preset",
+                             graphics_settings_grid.get_at(0, 7));
+        add_navigable_dropdown(graphics_settings_ui, UIState::GRAPHICS_SETTINGS, "quality preset", on_click_settings,
+                               on_hover, dropdown_option_idx, graphics_settings_grid.get_at(2, 7), colors::orange,
+                               colors::orangered, quality_preset_options, quality_preset_on_click, dropdown_on_hover);
+
+        std::function<void(std::string)> render_scale_on_click = [this](std::string option) {
+            play_ui_sound(SoundType::CLICK);
+            set_config_value("graphics", "render_scale", option);
+        };
+
+        std::vector<std::string> render_scale_options = {"adaptive", "50", "60", "70", "80", "90", "100"};
+        dropdown_option_idx = get_index_or_default(get_config_value("graphics", "render_scale").value_or("100"),
+                                                   render_scale_options);
+        add_searchable_label(graphics_settings_ui, UIState::GRAPHICS_SETTINGS, "render scale",
+                             graphics_settings_grid.get_at(0, 8));
+        add_navigable_dropdown(graphics_settings_ui, UIState::GRAPHICS_SETTINGS, "render scale", on_click_settings,
+                               on_hover, dropdown_option_idx, graphics_settings_grid.get_at(2, 8), colors::orange,
+                               colors::orangered, render_scale_options, render_scale_on_click, dropdown_on_hover);
+
+        std::function<void(std::string)> vsync_on_click = [this](std::string option) {
+            play_ui_sound(SoundType::CLICK);
+            set_config_value("graphics", "vsync", option);
+        };
+
+        std::vector<std::string> vsync_options = {"off", "on", "adaptive"};
+        dropdown_option_idx =
+            get_index_or_default(get_config_value("graphics", "vsync").value_or("on"), vsync_options);
+        add_searchable_label(graphics_settings_ui, UIState::GRAPHICS_SETTINGS, "vsync",
+                             graphics_settings_grid.get_at(0, 9));
+        add_navigable_dropdown(graphics_settings_ui, UIState::GRAPHICS_SETTINGS, "vsync", on_click_settings, on_hover,
+                               dropdown_option_idx, graphics_settings_grid.get_at(2, 9), colors::orange,
+                               colors::orangered, vsync_options, vsync_on_click, dropdown_on_hover);
+
+        std::function<void(std::string)> low_latency_on_click = [this](std::string option) {
+            play_ui_sound(SoundType::CLICK);
+            set_config_value("graphics", "low_latency", option);
         };
 
-        graphics_settings_ui.add_textbox("show pos", graphics_settings_grid.get_at(0, 6), colors::maroon);
-        graphics_settings_ui.add_dropdown(on_click_settings, on_hover, dropdown_option_idx,
-                                          graphics_settings_grid.get_at(2, 6), colors::orange, colors::orangered,
-                                          on_off_options, show_pos_on_click, dropdown_on_hover);
+        dropdown_option_idx =
+            get_index_or_default(get_config_value("graphics", "low_latency").value_or("off"), on_off_options);
+        add_searchable_label(graphics_settings_ui, UIState::GRAPHICS_SETTINGS, "low latency",
+                             graphics_settings_grid.get_at(0, 10));
+        add_navigable_dropdown(graphics_settings_ui, UIState::GRAPHICS_SETTINGS, "low latency", on_click_settings,
+                               on_hover, dropdown_option_idx, graphics_settings_grid.get_at(2, 10), colors::orange,
+                               colors::orangered, on_off_options, low_latency_on_click, dropdown_on_hover);
 
         return graphics_settings_ui;
     }
@@ -633,19 +6108,31 @@ class InputGraphicsSoundMenu {
      *
      * @return A fully constructed UI object for advanced diagnostics settings.
      *
-     * @details Provides toggles for visualizing tick time, ping, and movement dial indicators.
+     * @details Provides toggles for visualizing tick time, ping, and movement dial indicators, and shows the current
+     *          render scale along with the state of the dynamic resolution controller.
      */
     UI create_advanced_settings_ui() {
 
         vertex_geometry::Rectangle main_settings_rect = settings_menu.at(1);
         vertex_geometry::Grid main_settings_grid(7, 3, main_settings_rect);
 
-        vertex_geometry::Grid advanced_settings_grid(3, 3, main_settings_rect);
+        vertex_geometry::Grid advanced_settings_grid(5, 3, main_settings_rect);
         UI advanced_settings_ui(-0.1, batcher.absolute_position_with_colored_vertex_shader_batcher.object_id_generator);
-        advanced_settings_ui.add_textbox("display tick time expendature", advanced_settings_grid.get_at(0, 0),
-                                         colors::maroon);
-        advanced_settings_ui.add_textbox("display current ping", advanced_settings_grid.get_at(0, 1), colors::maroon);
-        advanced_settings_ui.add_textbox("display movement dial", advanced_settings_grid.get_at(0, 2), colors::maroon);
+        add_searchable_label(advanced_settings_ui, UIState::ADVANCED_SETTINGS, "display tick time expendature",
+                             advanced_settings_grid.get_at(0, 0));
+        add_searchable_label(advanced_settings_ui, UIState::ADVANCED_SETTINGS, "display current ping",
+                             advanced_settings_grid.get_at(0, 1));
+        add_searchable_label(advanced_settings_ui, UIState::ADVANCED_SETTINGS, "display movement dial",
+                             advanced_settings_grid.get_at(0, 2));
+
+        add_searchable_label(advanced_settings_ui, UIState::ADVANCED_SETTINGS, "render scale",
+                             advanced_settings_grid.get_at(0, 3));
+        render_scale_textbox_id =
+            advanced_settings_ui.add_textbox("100%", advanced_settings_grid.get_at(2, 3), colors::grey);
+        add_searchable_label(advanced_settings_ui, UIState::ADVANCED_SETTINGS, "render scale controller",
+                             advanced_settings_grid.get_at(0, 4));
+        render_scale_state_textbox_id =
+            advanced_settings_ui.add_textbox("fixed", advanced_settings_grid.get_at(2, 4), colors::grey);
 
         return advanced_settings_ui;
     }
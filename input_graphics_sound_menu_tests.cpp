@@ -0,0 +1,200 @@
+#include "input_graphics_sound_menu.hpp"
+
+/**
+ * Checks of the parts of the menu that don't need a window, and a run of the mixing benchmark. Build it with the same
+ * include paths as input_graphics_sound_menu.cpp and run it, it exits with 1 if any check fails.
+ */
+
+namespace {
+
+int num_failed_checks = 0;
+
+void check(bool condition, const std::string &description) {
+    if (!condition) {
+        std::cerr << "FAILED: " << description << std::endl;
+        num_failed_checks++;
+    }
+}
+
+bool nearly_equal(float a, float b) { return std::abs(a - b) < 1e-5f; }
+
+void test_sound_bus_mixer_applies_bus_gains() {
+    SoundBusMixer mixer;
+    mixer.configure(64);
+    std::vector<float> music(64, 1.0f), effects(64, 1.0f), output(64);
+    std::vector<const float *> voices = {music.data(), effects.data()};
+    std::vector<SoundBus> voice_buses = {SoundBus::MUSIC, SoundBus::EFFECTS};
+
+    mixer.mix(voices, voice_buses, output.data(), output.size());
+    check(nearly_equal(output.back(), 2.0f), "voices are summed at full gain");
+
+    mixer.set_bus_gain(SoundBus::MUSIC, 0.5f);
+    mixer.set_bus_gain(SoundBus::MASTER, 0.5f);
+    check(nearly_equal(mixer.get_effective_gain(SoundBus::MUSIC), 0.25f), "master scales the effective gain");
+
+    // the first block ramps to the new gains and ends exactly on them, the next one is flat
+    mixer.mix(voices, voice_buses, output.data(), output.size());
+    check(output.front() > output.back(), "a gain change is ramped over the block");
+    check(nearly_equal(output.back(), 0.75f), "the ramp ends on the target gain");
+    mixer.mix(voices, voice_buses, output.data(), output.size());
+    check(nearly_equal(output.front(), 0.75f) && nearly_equal(output.back(), 0.75f), "the gain holds after the ramp");
+
+    mixer.set_bus_gain(SoundBus::EFFECTS, 2.0f);
+    check(mixer.get_bus_gain(SoundBus::EFFECTS) == 1.0f, "gains are clamped to 1");
+}
+
+void test_sound_bus_mixer_mixes_large_blocks_in_pieces() {
+    SoundBusMixer mixer;
+    mixer.configure(16);
+    std::vector<float> voice(100), output(100);
+    for (std::size_t i = 0; i < voice.size(); ++i) {
+        voice[i] = static_cast<float>(i);
+    }
+    mixer.mix({voice.data()}, {SoundBus::UI}, output.data(), output.size());
+    check(output == voice, "a block larger than the configured size is mixed unchanged at full gain");
+}
+
+void test_persistent_settings_map_keeps_old_versions() {
+    PersistentSettingsMap empty;
+    PersistentSettingsMap first = empty.set({"sound", "master_volume"}, "50");
+    PersistentSettingsMap second = first.set({"sound", "master_volume"}, "80");
+
+    check(!empty.get({"sound", "master_volume"}).has_value(), "setting a value leaves the old version empty");
+    check(first.get({"sound", "master_volume"}) == "50", "the first version keeps its value");
+    check(second.get({"sound", "master_volume"}) == "80", "the second version has the new value");
+
+    PersistentSettingsMap many;
+    for (int i = 0; i < 200; ++i) {
+        many = many.set({"section", std::to_string(i)}, std::to_string(i * 2));
+    }
+    bool all_found = true;
+    for (int i = 0; i < 200; ++i) {
+        all_found = all_found && many.get({"section", std::to_string(i)}) == std::to_string(i * 2);
+    }
+    check(all_found, "every key set is found again");
+}
+
+void test_settings_history_undo_and_redo() {
+    SettingsHistory history;
+    check(!history.can_undo() && !history.can_redo(), "a new history has nothing to undo or redo");
+
+    // one click that changes two keys is a single step
+    history.record({"graphics", "resolution"}, "1280x720", "1920x1080");
+    history.record({"graphics", "fullscreen"}, std::nullopt, "on");
+    history.commit_step();
+    history.record({"graphics", "resolution"}, "1920x1080", "2560x1440");
+    history.commit_step();
+
+    ConfigChanges undone = history.undo();
+    check(undone == ConfigChanges{{"graphics", "resolution", "1920x1080"}}, "undo restores the previous value");
+
+    undone = history.undo();
+    check(undone == ConfigChanges{{"graphics", "resolution", "1280x720"}, {"graphics", "fullscreen", std::nullopt}},
+          "undoing a step restores all of its keys and removes the ones that weren't set");
+    check(!history.can_undo(), "there is nothing left to undo");
+
+    ConfigChanges redone = history.redo();
+    check(redone == ConfigChanges{{"graphics", "resolution", "1920x1080"}, {"graphics", "fullscreen", "on"}},
+          "redo sets the values of the step again");
+
+    history.record({"sound", "master_volume"}, "100", "40");
+    history.commit_step();
+    check(!history.can_redo(), "a new step drops the redo steps");
+
+    SettingsHistory short_history(2);
+    for (int i = 0; i < 5; ++i) {
+        short_history.record({"sound", "ui_volume"}, std::to_string(i), std::to_string(i + 1));
+        short_history.commit_step();
+    }
+    short_history.undo();
+    short_history.undo();
+    check(!short_history.can_undo(), "only max_steps steps are kept");
+}
+
+void test_virtualized_list_highlight() {
+    std::vector<std::string> items;
+    for (int i = 0; i < 50; ++i) {
+        items.push_back(std::to_string(i));
+    }
+    VirtualizedList list(items, 8);
+
+    list.move_highlight(-3);
+    check(list.get_highlighted_item() == 0, "the highlight stops at the first item");
+    list.move_highlight(20);
+    check(list.get_highlighted_item() == 20, "the highlight moves by the given amount");
+    list.move_highlight(100);
+    check(list.get_highlighted_item() == 49, "the highlight stops at the last item");
+    list.scroll_to(1000);
+    check(list.get_highlighted_item() == 49, "scroll_to clamps to the last item");
+    check(list.get_num_items() == 50, "the list holds every item");
+
+    VirtualizedList empty_list({}, 8);
+    empty_list.move_highlight(1);
+    empty_list.scroll_to(3);
+    check(empty_list.get_highlighted_item() == 0, "an empty list keeps the highlight at 0");
+}
+
+void test_trigram_search() {
+    TrigramSearchIndex index;
+    std::size_t wireframe = index.add("wireframe");
+    std::size_t fullscreen = index.add("fullscreen");
+    std::size_t master_volume = index.add("master volume");
+    std::size_t music_volume = index.add("music volume");
+
+    check(index.search("") == std::vector<std::size_t>{wireframe, fullscreen, master_volume, music_volume},
+          "an empty query returns every text in order");
+
+    std::vector<std::size_t> wire_results = index.search("wire");
+    check(!wire_results.empty() && wire_results.front() == wireframe, "a prefix finds its text");
+
+    // going back to an empty query and typing the same again must not list a text twice
+    index.search("");
+    check(index.search("wire") == wire_results, "searching again after clearing gives the same results");
+
+    std::vector<std::size_t> volume_results = index.search("volume");
+    check(volume_results.size() == 2 && std::count(volume_results.begin(), volume_results.end(), master_volume) == 1 &&
+              std::count(volume_results.begin(), volume_results.end(), music_volume) == 1,
+          "a shared word finds every text containing it, once each");
+
+    check(index.search("Fulscreen").front() == fullscreen, "a typo in a query still finds the text");
+    check(index.search("zzzz").empty(), "a query sharing nothing matches nothing");
+}
+
+void test_read_config_values() {
+    std::string path = (std::filesystem::temp_directory_path() / "input_graphics_sound_menu_tests.ini").string();
+    check(write_file_atomically(path, "[graphics]\nfield_of_view = 100\n\n[sound]\nmaster_volume = 40\n"),
+          "the ini is written");
+
+    ConfigEntries entries =
+        read_config_values(path, {{"graphics", "field_of_view"}, {"sound", "master_volume"}, {"sound", "ui_volume"}});
+    check(entries == ConfigEntries{{"graphics", "field_of_view", "100"}, {"sound", "master_volume", "40"}},
+          "the keys in the ini are read and missing ones are left out");
+    std::filesystem::remove(path);
+}
+
+void benchmark_sound_bus_mixer() {
+    double voice_frames_per_second = SoundBusMixer::benchmark_mixing_throughput();
+    check(voice_frames_per_second > 0, "the mixing benchmark measures a throughput");
+    std::cout << "mixing throughput: " << voice_frames_per_second / 1e6 << " million voice frames per second"
+              << std::endl;
+}
+
+} // namespace
+
+int main() {
+    test_sound_bus_mixer_applies_bus_gains();
+    test_sound_bus_mixer_mixes_large_blocks_in_pieces();
+    test_persistent_settings_map_keeps_old_versions();
+    test_settings_history_undo_and_redo();
+    test_virtualized_list_highlight();
+    test_trigram_search();
+    test_read_config_values();
+    benchmark_sound_bus_mixer();
+
+    if (num_failed_checks > 0) {
+        std::cerr << num_failed_checks << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}